@@ -1,5 +1,5 @@
 TEMPLATE = app
-QT       += core gui serialport svg opengl
+QT       += core gui serialport svg opengl concurrent
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets printsupport
 
@@ -48,16 +48,24 @@ CONFIG(debug, debug|release) {
 SOURCES += \
     classes/aclass.cpp \
     classes/annotation.cpp \
+    classes/batchedleastsquaresfitter.cpp \
+    classes/classificationworker.cpp \
+    classes/classifierensemble.cpp \
+    classes/classifierinputcache.cpp \
     classes/controler.cpp \
+    classes/curvefitcache.cpp \
     classes/datasource.cpp \
     classes/enosecolor.cpp \
     classes/fakedatasource.cpp \
+    classes/fitmodelregistry.cpp \
     classes/functionalisation.cpp \
+    classes/functionalisationindex.cpp \
     classes/leastsquaresfitter.cpp \
     classes/measurementdata.cpp \
     classes/mvector.cpp \
     classes/torchclassifier.cpp \
     classes/usbdatasource.cpp \
+    classes/windowbuffer.cpp \
     classes/curvefitworker.cpp \
     lib/comboboxitemdelegate.cpp \
     lib/dlib/dlib/all/source.cpp \
@@ -74,28 +82,42 @@ SOURCES += \
     widgets/curvefitwizard.cpp \
     widgets/functionalisationdialog.cpp \
     widgets/generalsettings.cpp \
+    widgets/graphexporter.cpp \
     widgets/infowidget.cpp \
     widgets/linegraphwidget.cpp \
+    widgets/livefitwidget.cpp \
     widgets/mainwindow.cpp \
+    widgets/plotcanvas.cpp \
+    widgets/renderscheduler.cpp \
     widgets/setsensorfailuresdialog.cpp \
     widgets/sourcedialog.cpp \
+    widgets/timeaxis.cpp \
     widgets/usbsettingswidget.cpp \
 
 HEADERS += \
     classes/aclass.h \
     classes/annotation.h \
+    classes/batchedleastsquaresfitter.h \
+    classes/classificationworker.h \
+    classes/classifierensemble.h \
+    classes/classifierinputcache.h \
     classes/classifier_definitions.h \
     classes/controler.h \
+    classes/curvefitcache.h \
     classes/datasource.h \
     classes/defaultSettings.h \
     classes/enosecolor.h \
     classes/fakedatasource.h \
+    classes/fitmodelregistry.h \
+    classes/fitmodels.h \
     classes/functionalisation.h \
+    classes/functionalisationindex.h \
     classes/leastsquaresfitter.h \
     classes/measurementdata.h \
     classes/mvector.h \
     classes/torchclassifier.h \
     classes/usbdatasource.h \
+    classes/windowbuffer.h \
     classes/curvefitworker.h \
     lib/comboboxitemdelegate.h \
     lib/spoiler.h \
@@ -112,11 +134,16 @@ HEADERS += \
     widgets/fixedplotzoomer.h \
     widgets/functionalisationdialog.h \
     widgets/generalsettings.h \
+    widgets/graphexporter.h \
     widgets/infowidget.h \
     widgets/linegraphwidget.h \
+    widgets/livefitwidget.h \
     widgets/mainwindow.h \
+    widgets/plotcanvas.h \
+    widgets/renderscheduler.h \
     widgets/setsensorfailuresdialog.h \
     widgets/sourcedialog.h \
+    widgets/timeaxis.h \
     widgets/usbsettingswidget.h \
 
 FORMS += \
@@ -0,0 +1,81 @@
+#include "batchedleastsquaresfitter.h"
+
+#include "defaultSettings.h"
+#include "fitmodelregistry.h"
+
+AbstractBatchedLeastSquaresFitter::AbstractBatchedLeastSquaresFitter(const std::vector<std::vector<std::pair<double, double>>> &channelSamples):
+    nChannels(channelSamples.size()),
+    nTime(0),
+    nSamples(channelSamples.size(), 0),
+    t_first(channelSamples.size(), 0.),
+    t_last(channelSamples.size(), 0.),
+    y_max(channelSamples.size(), 0.),
+    bestError(channelSamples.size(), std::numeric_limits<double>::infinity()),
+    valid(channelSamples.size(), false)
+{
+    for (size_t c=0; c<nChannels; c++)
+        nTime = std::max(nTime, channelSamples[c].size());
+
+    // fill structure of arrays:
+    // padded samples repeat the last sample of the channel, so they stay in the numeric range of the channel
+    x.assign(nTime * nChannels, 0.);
+    y.assign(nTime * nChannels, 0.);
+    weight.assign(nTime * nChannels, 0.);
+
+    for (size_t c=0; c<nChannels; c++)
+    {
+        const auto &samples = channelSamples[c];
+        nSamples[c] = samples.size();
+
+        if (samples.empty())
+            continue;
+
+        t_first[c] = std::numeric_limits<double>::infinity();
+        for (size_t i=0; i<nTime; i++)
+        {
+            const auto &sample = i < samples.size() ? samples[i] : samples.back();
+
+            x[i * nChannels + c] = sample.first;
+            y[i * nChannels + c] = sample.second;
+            weight[i * nChannels + c] = i < samples.size() ? 1. : 0.;
+
+            if (i < samples.size())
+            {
+                t_first[c] = std::min(t_first[c], sample.first);
+                t_last[c] = std::max(t_last[c], sample.first);
+                y_max[c] = std::max(y_max[c], sample.second);
+            }
+        }
+    }
+
+    bestParams.assign(nChannels, std::vector<double>());
+}
+
+/*!
+ * \brief AbstractBatchedLeastSquaresFitter::create creates a batched fitter for the model of \param type registered in FitModelRegistry.
+ * The caller takes ownership.
+ */
+AbstractBatchedLeastSquaresFitter *AbstractBatchedLeastSquaresFitter::create(LeastSquaresFitter::Type type, const std::vector<std::vector<std::pair<double, double> > > &channelSamples)
+{
+    return FitModelRegistry::createBatchedFitter(type, channelSamples);
+}
+
+size_t AbstractBatchedLeastSquaresFitter::size() const
+{
+    return nChannels;
+}
+
+bool AbstractBatchedLeastSquaresFitter::isValid(size_t channel) const
+{
+    return valid[channel];
+}
+
+std::vector<double> AbstractBatchedLeastSquaresFitter::getParams(size_t channel) const
+{
+    return bestParams[channel];
+}
+
+double AbstractBatchedLeastSquaresFitter::residual_sum_of_sqares(size_t channel) const
+{
+    return bestError[channel];
+}
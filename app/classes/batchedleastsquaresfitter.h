@@ -0,0 +1,421 @@
+#ifndef BATCHEDLEASTSQUARESFITTER_H
+#define BATCHEDLEASTSQUARESFITTER_H
+
+#include <array>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include <dlib/rand.h>
+#include <QtCore>
+
+#include "leastsquaresfitter.h"
+
+#define BATCHED_FIT_DEFAULT_BATCH_SIZE 16   // number of channels fitted in lockstep
+#define BATCHED_FIT_MIN_DELTA 1e-7          // stop criterion: min change of the residual sum of squares
+#define BATCHED_FIT_INITIAL_LAMBDA 1e-3
+#define BATCHED_FIT_MAX_LAMBDA 1e10
+
+/*!
+ * \brief The AbstractBatchedLeastSquaresFitter class stores the samples of multiple channels
+ * in a channels x time structure-of-arrays layout and the best fit result of each channel.
+ * The fit itself is implemented by BatchedLeastSquaresFitter, instances are created with AbstractBatchedLeastSquaresFitter::create.
+ */
+class AbstractBatchedLeastSquaresFitter
+{
+public:
+    explicit AbstractBatchedLeastSquaresFitter(const std::vector<std::vector<std::pair<double, double>>> &channelSamples);
+    virtual ~AbstractBatchedLeastSquaresFitter() {}
+
+    static AbstractBatchedLeastSquaresFitter* create(LeastSquaresFitter::Type type, const std::vector<std::vector<std::pair<double, double>>> &channelSamples);
+
+    virtual void solve_lm(int nIterations = LEAST_SQUARES_N_FITS, double limitFactor = LEAST_SQUARES_LIMIT_FACTOR) = 0;
+
+    size_t size() const;
+
+    bool isValid(size_t channel) const;
+
+    std::vector<double> getParams(size_t channel) const;
+
+    double residual_sum_of_sqares(size_t channel) const;
+
+protected:
+    size_t nChannels;
+    size_t nTime;
+
+    // sample i of channel c is stored at index i * nChannels + c,
+    // channels with less samples are padded with weight 0
+    std::vector<double> x, y, weight;
+    std::vector<size_t> nSamples;
+    std::vector<double> t_first, t_last, y_max;
+
+    // bestParams[c] contains the parameters of channel c
+    std::vector<std::vector<double>> bestParams;
+    std::vector<double> bestError;
+    std::vector<bool> valid;
+};
+
+/*!
+ * \brief The BatchedLeastSquaresFitter class fits Model to multiple channels at once.
+ * The Levenberg-Marquardt iterations of all channels advance in lockstep and the inner loops run over contiguous channel values.
+ * Channels that converged are masked out of the following iterations.
+ */
+template<class Model>
+class BatchedLeastSquaresFitter : public AbstractBatchedLeastSquaresFitter
+{
+public:
+    static const long nParams = Model::nParams;
+
+    explicit BatchedLeastSquaresFitter(const std::vector<std::vector<std::pair<double, double>>> &channelSamples);
+
+    void solve_lm(int nIterations = LEAST_SQUARES_N_FITS, double limitFactor = LEAST_SQUARES_LIMIT_FACTOR) override;
+
+    using AbstractBatchedLeastSquaresFitter::residual_sum_of_sqares;
+
+private:
+    typedef dlib::matrix<double, nParams, 1> parameter_vector;
+    typedef std::array<std::vector<double>, nParams> ParameterArray;
+    typedef std::array<std::vector<double>, nParams * (nParams+1) / 2> NormalMatrixArray;
+
+    dlib::rand rnd;
+
+    void getRandomParameters(ParameterArray &params);
+
+    void levenberg_marquardt(ParameterArray &params, std::vector<double> &cost) const;
+
+    void residual_sum_of_sqares(const ParameterArray &params, const std::vector<double> &mask, std::vector<double> &cost) const;
+
+    void normal_equations(const ParameterArray &params, const std::vector<double> &mask, NormalMatrixArray &JtJ, ParameterArray &Jtr, std::vector<double> &cost) const;
+
+    static bool solve_damped(const NormalMatrixArray &JtJ, const ParameterArray &Jtr, size_t channel, double lambda, std::array<double, nParams> &delta);
+
+    // index of element (i, j), i <= j, of the symmetric normal matrix in packed storage
+    static long packedIndex(long i, long j) { return i * nParams - i * (i - 1) / 2 + (j - i); }
+
+    static parameter_vector channelParameters(const ParameterArray &params, size_t channel);
+
+    void gatherParameters(const ParameterArray &params, std::vector<parameter_vector> &channelParams) const;
+};
+
+template<class Model>
+BatchedLeastSquaresFitter<Model>::BatchedLeastSquaresFitter(const std::vector<std::vector<std::pair<double, double>>> &channelSamples):
+    AbstractBatchedLeastSquaresFitter(channelSamples)
+{
+    for (auto &channelParams : bestParams)
+        channelParams.assign(nParams, 0.);
+}
+
+/*!
+ * \brief BatchedLeastSquaresFitter::solve_lm fits all channels \param nIterations times starting from random parameters.
+ * For each channel the valid result with the smallest residual sum of squares is kept.
+ * \param limitFactor results with a plateau greater than limitFactor * y_max of the channel are invalid
+ */
+template<class Model>
+void BatchedLeastSquaresFitter<Model>::solve_lm(int nIterations, double limitFactor)
+{
+    ParameterArray params;
+    for (long k=0; k<nParams; k++)
+        params[k].assign(nChannels, 0.);
+    std::vector<double> cost(nChannels, 0.);
+
+    for (int i=0; i<nIterations; i++)
+    {
+        getRandomParameters(params);
+        levenberg_marquardt(params, cost);
+
+        for (size_t c=0; c<nChannels; c++)
+        {
+            if (nSamples[c] == 0 || !std::isfinite(cost[c]))
+                continue;
+
+            if (!Model::parameters_valid(channelParameters(params, c), limitFactor * y_max[c]))
+                continue;
+
+            if (cost[c] < bestError[c])
+            {
+                bestError[c] = cost[c];
+                valid[c] = true;
+                for (long k=0; k<nParams; k++)
+                    bestParams[c][k] = params[k][c];
+            }
+        }
+    }
+}
+
+/*!
+ * \brief BatchedLeastSquaresFitter::getRandomParameters draws random start parameters for each channel.
+ * Uses the same ranges as ModelFitter::getRandomParameterVector.
+ */
+template<class Model>
+void BatchedLeastSquaresFitter<Model>::getRandomParameters(ParameterArray &params)
+{
+    parameter_vector p;
+    for (size_t c=0; c<nChannels; c++)
+    {
+        double t_range = t_last[c] - t_first[c];
+        double t_end = qFuzzyIsNull(t_range) ? t_first[c] + 1. : t_last[c];
+
+        for (long k=0; k<nParams; k++)
+            p(k) = rnd.get_random_double();
+        Model::scaleRandomParameters(p, t_first[c], t_end, y_max[c]);
+
+        for (long k=0; k<nParams; k++)
+            params[k][c] = p(k);
+    }
+}
+
+/*!
+ * \brief BatchedLeastSquaresFitter::levenberg_marquardt runs Levenberg-Marquardt iterations for all channels in lockstep.
+ * A channel is masked out as soon as the change of its residual sum of squares falls below BATCHED_FIT_MIN_DELTA
+ * or its damping factor exceeds BATCHED_FIT_MAX_LAMBDA.
+ * \param params start parameters, contain the result afterwards
+ * \param cost residual sum of squares of the result
+ */
+template<class Model>
+void BatchedLeastSquaresFitter<Model>::levenberg_marquardt(ParameterArray &params, std::vector<double> &cost) const
+{
+    // active: channel still iterating
+    // update: normal equations of the channel have to be recalculated
+    std::vector<double> active(nChannels, 0.), update(nChannels, 0.);
+    std::vector<double> lambda(nChannels, BATCHED_FIT_INITIAL_LAMBDA);
+    std::vector<double> newCost(nChannels, 0.);
+    size_t nActive = 0;
+    for (size_t c=0; c<nChannels; c++)
+    {
+        if (nSamples[c] > 0)
+        {
+            active[c] = 1.;
+            nActive++;
+        }
+    }
+
+    NormalMatrixArray JtJ;
+    for (auto &element : JtJ)
+        element.assign(nChannels, 0.);
+    ParameterArray Jtr, candidate;
+    for (long k=0; k<nParams; k++)
+    {
+        Jtr[k].assign(nChannels, 0.);
+        candidate[k] = params[k];
+    }
+
+    normal_equations(params, active, JtJ, Jtr, cost);
+
+    std::array<double, nParams> delta;
+    for (int iteration=0; iteration<LEAST_SQUARES_MAX_ITERATIONS && nActive > 0; iteration++)
+    {
+        // damped step for each active channel
+        for (size_t c=0; c<nChannels; c++)
+        {
+            if (active[c] == 0.)
+                continue;
+
+            if (!solve_damped(JtJ, Jtr, c, lambda[c], delta))
+            {
+                for (long k=0; k<nParams; k++)
+                    candidate[k][c] = params[k][c];
+                continue;
+            }
+
+            for (long k=0; k<nParams; k++)
+                candidate[k][c] = params[k][c] - delta[k];
+        }
+
+        residual_sum_of_sqares(candidate, active, newCost);
+
+        // accept or reject steps
+        for (size_t c=0; c<nChannels; c++)
+        {
+            update[c] = 0.;
+            if (active[c] == 0.)
+                continue;
+
+            if (std::isfinite(newCost[c]) && newCost[c] < cost[c])
+            {
+                bool converged = cost[c] - newCost[c] < BATCHED_FIT_MIN_DELTA;
+
+                for (long k=0; k<nParams; k++)
+                    params[k][c] = candidate[k][c];
+                cost[c] = newCost[c];
+                lambda[c] /= 10;
+
+                if (converged)
+                {
+                    active[c] = 0.;
+                    nActive--;
+                }
+                else
+                    update[c] = 1.;
+            }
+            else
+            {
+                lambda[c] *= 10;
+
+                if (lambda[c] > BATCHED_FIT_MAX_LAMBDA)
+                {
+                    active[c] = 0.;
+                    nActive--;
+                }
+            }
+        }
+
+        normal_equations(params, update, JtJ, Jtr, newCost);
+    }
+}
+
+/*!
+ * \brief BatchedLeastSquaresFitter::residual_sum_of_sqares calculates the residual sum of squares of all channels with mask[c] != 0
+ */
+template<class Model>
+void BatchedLeastSquaresFitter<Model>::residual_sum_of_sqares(const ParameterArray &params, const std::vector<double> &mask, std::vector<double> &cost) const
+{
+    for (size_t c=0; c<nChannels; c++)
+        if (mask[c] != 0.)
+            cost[c] = 0.;
+
+    double *costData = cost.data();
+
+    std::vector<parameter_vector> channelParams;
+    gatherParameters(params, channelParams);
+
+    for (size_t i=0; i<nTime; i++)
+    {
+        const double *x_i = x.data() + i * nChannels;
+        const double *y_i = y.data() + i * nChannels;
+        const double *w_i = weight.data() + i * nChannels;
+
+        // contiguous loop over channels:
+        // masked channels are multiplied by 0 instead of branching
+        for (size_t c=0; c<nChannels; c++)
+        {
+            const double m = w_i[c] * mask[c];
+            const double r = m * (Model::evaluate(x_i[c], channelParams[c], static_cast<parameter_vector*>(nullptr)) - y_i[c]);
+
+            costData[c] += r * r;
+        }
+    }
+}
+
+/*!
+ * \brief BatchedLeastSquaresFitter::normal_equations calculates J^T * J, J^T * r and the residual sum of squares of all channels with mask[c] != 0.
+ * J^T * J is stored in packed form (upper triangle).
+ */
+template<class Model>
+void BatchedLeastSquaresFitter<Model>::normal_equations(const ParameterArray &params, const std::vector<double> &mask, NormalMatrixArray &JtJ, ParameterArray &Jtr, std::vector<double> &cost) const
+{
+    for (size_t c=0; c<nChannels; c++)
+    {
+        if (mask[c] == 0.)
+            continue;
+
+        cost[c] = 0.;
+        for (auto &element : JtJ)
+            element[c] = 0.;
+        for (auto &element : Jtr)
+            element[c] = 0.;
+    }
+
+    std::vector<parameter_vector> channelParams;
+    gatherParameters(params, channelParams);
+
+    parameter_vector J;
+    for (size_t i=0; i<nTime; i++)
+    {
+        const double *x_i = x.data() + i * nChannels;
+        const double *y_i = y.data() + i * nChannels;
+        const double *w_i = weight.data() + i * nChannels;
+
+        for (size_t c=0; c<nChannels; c++)
+        {
+            const double m = w_i[c] * mask[c];
+
+            // partial derivatives of the model
+            const double r = m * (Model::evaluate(x_i[c], channelParams[c], &J) - y_i[c]);
+
+            cost[c] += r * r;
+            for (long k=0; k<nParams; k++)
+            {
+                const double J_k = m * J(k);
+                Jtr[k][c] += J_k * r;
+                for (long l=k; l<nParams; l++)
+                    JtJ[packedIndex(k, l)][c] += J_k * m * J(l);
+            }
+        }
+    }
+}
+
+/*!
+ * \brief BatchedLeastSquaresFitter::solve_damped solves (J^T * J + lambda * diag(J^T * J)) * delta = J^T * r for \param channel
+ * using a Cholesky decomposition.
+ * \return false if the damped matrix is not positive definite
+ */
+template<class Model>
+bool BatchedLeastSquaresFitter<Model>::solve_damped(const NormalMatrixArray &JtJ, const ParameterArray &Jtr, size_t channel, double lambda, std::array<double, nParams> &delta)
+{
+    double L[nParams][nParams] = {};
+
+    for (long j=0; j<nParams; j++)
+    {
+        double diagonal = JtJ[packedIndex(j, j)][channel];
+        double sum = diagonal * (1 + lambda) + 1e-12;
+        for (long k=0; k<j; k++)
+            sum -= L[j][k] * L[j][k];
+
+        if (!(sum > 0.))
+            return false;
+        L[j][j] = std::sqrt(sum);
+
+        for (long i=j+1; i<nParams; i++)
+        {
+            double value = JtJ[packedIndex(j, i)][channel];
+            for (long k=0; k<j; k++)
+                value -= L[i][k] * L[j][k];
+            L[i][j] = value / L[j][j];
+        }
+    }
+
+    // forward substitution: L * z = J^T * r
+    std::array<double, nParams> z;
+    for (long i=0; i<nParams; i++)
+    {
+        double value = Jtr[i][channel];
+        for (long k=0; k<i; k++)
+            value -= L[i][k] * z[k];
+        z[i] = value / L[i][i];
+    }
+
+    // backward substitution: L^T * delta = z
+    for (long i=nParams-1; i>=0; i--)
+    {
+        double value = z[i];
+        for (long k=i+1; k<nParams; k++)
+            value -= L[k][i] * delta[k];
+        delta[i] = value / L[i][i];
+    }
+
+    return true;
+}
+
+template<class Model>
+typename BatchedLeastSquaresFitter<Model>::parameter_vector BatchedLeastSquaresFitter<Model>::channelParameters(const ParameterArray &params, size_t channel)
+{
+    parameter_vector p;
+    for (long k=0; k<nParams; k++)
+        p(k) = params[k][channel];
+
+    return p;
+}
+
+/*!
+ * \brief BatchedLeastSquaresFitter::gatherParameters gathers the parameters of each channel from the parameter columns.
+ * Called once per evaluation of all samples, so the loops over the samples only read contiguous per-channel parameters.
+ */
+template<class Model>
+void BatchedLeastSquaresFitter<Model>::gatherParameters(const ParameterArray &params, std::vector<parameter_vector> &channelParams) const
+{
+    channelParams.resize(nChannels);
+    for (size_t c=0; c<nChannels; c++)
+        channelParams[c] = channelParameters(params, c);
+}
+
+#endif // BATCHEDLEASTSQUARESFITTER_H
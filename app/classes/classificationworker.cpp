@@ -0,0 +1,186 @@
+#include "classificationworker.h"
+
+#include <algorithm>
+
+ClassificationWorker::ClassificationWorker(ClassifierEnsemble *classifier, const std::vector<uint> &timestamps, const std::vector<std::vector<double>> &inputs, int batchSize, int nThreads, QObject *parent):
+    QObject(parent),
+    classifier(classifier),
+    timestamps(timestamps),
+    inputs(inputs),
+    batchSize(batchSize),
+    nThreads(nThreads)
+{
+    Q_ASSERT(classifier != nullptr);
+    Q_ASSERT(timestamps.size() == inputs.size());
+    Q_ASSERT(batchSize > 0);
+}
+
+/*!
+ * \brief ClassificationWorker::cancel stops the classification after the current batch.
+ * Can be called from any thread.
+ */
+void ClassificationWorker::cancel()
+{
+    cancelled = true;
+}
+
+bool ClassificationWorker::isCancelled() const
+{
+    return cancelled;
+}
+
+/*!
+ * \brief ClassificationWorker::start classifies all inputs in batches of batchSize.
+ * The intra-op thread count of torch is set for the worker thread if nThreads > 0.
+ * Emits annotationsReady at most every CLASSIFICATION_WORKER_EMIT_INTERVAL ms and finished when done or cancelled.
+ */
+void ClassificationWorker::start()
+{
+    if (nThreads > 0)
+        at::set_num_threads(nThreads);
+
+    int nTotal = static_cast<int>(inputs.size());
+    QMap<uint, Annotation> chunk;
+    QElapsedTimer emitTimer;
+    emitTimer.start();
+
+    for (size_t first=0; first<inputs.size() && !cancelled; first+=batchSize)
+    {
+        size_t last = std::min(first + batchSize, inputs.size());
+
+        QList<Annotation> annotations;
+        try {
+            std::vector<std::vector<double>> batch(std::make_move_iterator(inputs.begin()+first), std::make_move_iterator(inputs.begin()+last));
+            annotations = classifier->getAnnotations(batch, batchSize);
+        } catch (std::invalid_argument& e) {
+            emit error(e.what());
+            emit finished(true);
+            return;
+        }
+
+        for (size_t i=first; i<last; i++)
+            chunk.insert(chunk.constEnd(), timestamps[i], annotations[static_cast<int>(i-first)]);
+
+        if (emitTimer.elapsed() >= CLASSIFICATION_WORKER_EMIT_INTERVAL || last == inputs.size())
+        {
+            emit annotationsReady(chunk);
+            emit progress(static_cast<int>(last), nTotal);
+
+            chunk.clear();
+            emitTimer.restart();
+        }
+    }
+
+    // results of the last batch before a cancel
+    if (!chunk.isEmpty())
+        emit annotationsReady(chunk);
+
+    emit finished(cancelled);
+}
+
+LiveClassificationWorker::LiveClassificationWorker(ClassifierEnsemble *classifier, int nThreads, QObject *parent):
+    QObject(parent),
+    classifier(classifier),
+    nThreads(nThreads)
+{
+    Q_ASSERT(classifier != nullptr);
+
+    clock.start();
+}
+
+/*!
+ * \brief LiveClassificationWorker::start prepares the worker thread. Should be invoked after moving the worker to its thread.
+ */
+void LiveClassificationWorker::start()
+{
+    if (nThreads > 0)
+        at::set_num_threads(nThreads);
+
+    statisticsTimer.start();
+}
+
+/*!
+ * \brief LiveClassificationWorker::enqueue adds \a input at \a timestamp to the queue and schedules its classification.
+ * Can be called from any thread and never waits for the inference.
+ */
+void LiveClassificationWorker::enqueue(uint timestamp, const std::vector<double> &input)
+{
+    QMutexLocker locker(&queueMutex);
+
+    // inference falls behind:
+    // skip the oldest vector
+    if (queue.size() >= LIVE_CLASSIFICATION_MAX_BATCH_SIZE)
+    {
+        queue.removeFirst();
+        nSkipped++;
+    }
+
+    queue.append(Sample{timestamp, input, clock.nsecsElapsed()});
+
+    if (!classifyScheduled)
+    {
+        classifyScheduled = true;
+        QMetaObject::invokeMethod(this, "classifyQueue", Qt::QueuedConnection);
+    }
+}
+
+/*!
+ * \brief LiveClassificationWorker::classifyQueue classifies all queued vectors in one batch.
+ */
+void LiveClassificationWorker::classifyQueue()
+{
+    QList<Sample> batch;
+    {
+        QMutexLocker locker(&queueMutex);
+        batch.swap(queue);
+        classifyScheduled = false;
+    }
+
+    if (batch.isEmpty())
+        return;
+
+    std::vector<std::vector<double>> inputs;
+    inputs.reserve(batch.size());
+    for (const Sample &sample : batch)
+        inputs.push_back(sample.input);
+
+    QList<Annotation> annotations;
+    try {
+        annotations = classifier->getAnnotations(inputs, LIVE_CLASSIFICATION_MAX_BATCH_SIZE);
+    } catch (std::invalid_argument& e) {
+        emit error(e.what());
+        return;
+    }
+
+    QMap<uint, Annotation> annotationMap;
+    for (int i=0; i<batch.size(); i++)
+        annotationMap[batch[i].timestamp] = annotations[i];
+    emit annotationsReady(annotationMap);
+
+    // latency: time between enqueue and classification result
+    qint64 now = clock.nsecsElapsed();
+    for (const Sample &sample : batch)
+    {
+        double latency = (now - sample.receivedAt) / 1e6;
+        latencySum += latency;
+        latencyMax = std::max(latencyMax, latency);
+    }
+    nClassified += batch.size();
+
+    if (statisticsTimer.elapsed() >= LIVE_CLASSIFICATION_STATISTICS_INTERVAL)
+    {
+        int skipped;
+        {
+            QMutexLocker locker(&queueMutex);
+            skipped = nSkipped;
+            nSkipped = 0;
+        }
+
+        emit statistics(latencySum / nClassified, latencyMax, nClassified, skipped);
+
+        latencySum = 0.;
+        latencyMax = 0.;
+        nClassified = 0;
+        statisticsTimer.restart();
+    }
+}
@@ -0,0 +1,103 @@
+#ifndef CLASSIFICATIONWORKER_H
+#define CLASSIFICATIONWORKER_H
+
+#include <QObject>
+#include <QtCore>
+
+#include <atomic>
+#include <vector>
+
+#include "classifierensemble.h"
+#include "annotation.h"
+
+#define CLASSIFICATION_WORKER_EMIT_INTERVAL 250     // min time between two annotationsReady signals in ms
+
+// live classification settings
+#define LIVE_CLASSIFICATION_MAX_BATCH_SIZE 32           // max number of queued vectors, older vectors are skipped when inference falls behind
+#define LIVE_CLASSIFICATION_STATISTICS_INTERVAL 5000    // min time between two statistics signals in ms
+
+/*!
+ * \brief The ClassificationWorker class classifies a snapshot of input vectors in its own thread.
+ * Results are streamed back in chunks with annotationsReady, so the graphs are updated while the classification is running.
+ * The worker does not own the classifier, which must not be deleted before the worker has finished.
+ */
+class ClassificationWorker: public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ClassificationWorker(ClassifierEnsemble *classifier, const std::vector<uint> &timestamps, const std::vector<std::vector<double>> &inputs, int batchSize = TORCH_CLASSIFIER_DEFAULT_BATCH_SIZE, int nThreads = -1, QObject *parent = nullptr);
+
+    void cancel();
+
+    bool isCancelled() const;
+
+public Q_SLOTS:
+    void start();
+
+Q_SIGNALS:
+    void annotationsReady(const QMap<uint, Annotation> &annotations);
+    void progress(int nClassified, int nTotal);
+    void error(QString errorMessage);
+    void finished(bool cancelled);
+
+private:
+    ClassifierEnsemble *classifier;
+    std::vector<uint> timestamps;
+    std::vector<std::vector<double>> inputs;
+    int batchSize;
+    int nThreads;
+
+    std::atomic<bool> cancelled{false};
+};
+
+/*!
+ * \brief The LiveClassificationWorker class classifies vectors of a running measurement in its own thread.
+ * Vectors queued while a batch is classified are classified together in the next batch.
+ * If more than LIVE_CLASSIFICATION_MAX_BATCH_SIZE vectors are waiting, the oldest ones are skipped instead of blocking the caller.
+ */
+class LiveClassificationWorker: public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit LiveClassificationWorker(ClassifierEnsemble *classifier, int nThreads = -1, QObject *parent = nullptr);
+
+    void enqueue(uint timestamp, const std::vector<double> &input);
+
+public Q_SLOTS:
+    void start();
+
+Q_SIGNALS:
+    void annotationsReady(const QMap<uint, Annotation> &annotations);
+    void statistics(double meanLatency, double maxLatency, int nClassified, int nSkipped);
+    void error(QString errorMessage);
+
+private Q_SLOTS:
+    void classifyQueue();
+
+private:
+    struct Sample
+    {
+        uint timestamp;
+        std::vector<double> input;
+        qint64 receivedAt;  // in ns of clock
+    };
+
+    ClassifierEnsemble *classifier;
+    int nThreads;
+
+    QElapsedTimer clock;
+    QMutex queueMutex;
+    QList<Sample> queue;
+    bool classifyScheduled = false;
+    int nSkipped = 0;
+
+    // latency accounting since the last statistics signal
+    QElapsedTimer statisticsTimer;
+    double latencySum = 0.;
+    double latencyMax = 0.;
+    int nClassified = 0;
+};
+
+#endif // CLASSIFICATIONWORKER_H
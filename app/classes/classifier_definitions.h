@@ -3,7 +3,7 @@
 
 #define NO_SMELL_STRING "No Smell"
 
-enum class InputFunctionType {average, medianAverage, none};
+enum class InputFunctionType {average, medianAverage, trimmedMean, huber, clippedMean, none};
 enum class OutputFunctionType {logsoftmax, sigmoid, none};
 
 #endif // CLASSIFIER_H
@@ -0,0 +1,318 @@
+#include "classifierensemble.h"
+
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <exception>
+
+ClassifierEnsemble::ClassifierEnsemble(QObject *parent):
+    QObject(parent)
+{
+}
+
+ClassifierEnsemble::~ClassifierEnsemble()
+{
+    pool.waitForDone();
+}
+
+/*!
+ * \brief ClassifierEnsemble::addClassifier adds \a classifier to the ensemble, which takes ownership.
+ * Throws std::invalid_argument if the inputs, the output function or the label mode of \a classifier differ from the models already added.
+ */
+void ClassifierEnsemble::addClassifier(TorchClassifier *classifier)
+{
+    Q_ASSERT(classifier != nullptr);
+
+    if (!classifiers.isEmpty())
+    {
+        TorchClassifier *first = classifiers.first();
+        if (classifier->getN() != first->getN() ||
+                classifier->getW() != first->getW() ||
+                classifier->getIsInputAbsolute() != first->getIsInputAbsolute() ||
+                classifier->getInputFunctionType() != first->getInputFunctionType() ||
+                classifier->getPresetName() != first->getPresetName())
+            throw std::invalid_argument("Model " + classifier->getName().toStdString() + " takes different inputs than " + first->getName().toStdString() + ".");
+
+        if (classifier->getOutputFunctionType() != first->getOutputFunctionType() ||
+                classifier->getIsMultiLabel() != first->getIsMultiLabel())
+            throw std::invalid_argument("Model " + classifier->getName().toStdString() + " has a different output function or label mode than " + first->getName().toStdString() + ".");
+    }
+
+    classifier->setParent(this);
+    classifiers << classifier;
+    pool.setMaxThreadCount(classifiers.size());
+
+    QMutexLocker locker(&timesMutex);
+    modelTimes << 0.;
+}
+
+QList<TorchClassifier *> ClassifierEnsemble::getClassifiers() const
+{
+    return classifiers;
+}
+
+int ClassifierEnsemble::size() const
+{
+    return classifiers.size();
+}
+
+ClassifierEnsemble::CombinationMode ClassifierEnsemble::getCombinationMode() const
+{
+    return combinationMode;
+}
+
+void ClassifierEnsemble::setCombinationMode(CombinationMode mode)
+{
+    combinationMode = mode;
+}
+
+QMap<QString, ClassifierEnsemble::CombinationMode> ClassifierEnsemble::getCombinationModeMap()
+{
+    return QMap<QString, CombinationMode>{
+        {"average", CombinationMode::averaging},
+        {"vote", CombinationMode::voting}
+    };
+}
+
+Annotation ClassifierEnsemble::getAnnotation(const std::vector<double> &input)
+{
+    if (classifiers.size() == 1)
+        return classifiers.first()->getAnnotation(input);
+
+    return getAnnotations({input}, 1).first();
+}
+
+/*!
+ * \brief ClassifierEnsemble::getAnnotations classifies all vectors of \a inputs with each model and combines the annotations.
+ * The models run concurrently, each with an equal share of the torch intra-op threads of the calling thread.
+ * Throws std::invalid_argument if an input vector does not have W*N elements.
+ */
+QList<Annotation> ClassifierEnsemble::getAnnotations(const std::vector<std::vector<double>> &inputs, int batchSize)
+{
+    Q_ASSERT(!classifiers.isEmpty());
+
+    // one slot per model, written by the model's thread
+    std::vector<QList<Annotation>> modelAnnotations(classifiers.size());
+    std::vector<double> times(classifiers.size(), 0.);
+
+    int threadsPerModel = std::max(1, at::get_num_threads() / classifiers.size());
+
+    auto runModel = [&](int i) {
+        QElapsedTimer timer;
+        timer.start();
+        modelAnnotations[i] = classifiers.at(i)->getAnnotations(inputs, batchSize);
+        times[i] = timer.nsecsElapsed() / 1e6;
+    };
+
+    if (classifiers.size() == 1)
+    {
+        runModel(0);
+    }
+    else
+    {
+        // exceptions are passed on by the model's slot,
+        // QFuture only rethrows QExceptions
+        std::vector<std::exception_ptr> exceptions(classifiers.size());
+        QList<QFuture<void>> runs;
+
+        for (int i=0; i<classifiers.size(); i++)
+            runs << QtConcurrent::run(&pool, [&, i]() {
+                try {
+                    at::set_num_threads(threadsPerModel);
+                    runModel(i);
+                } catch (...) {
+                    exceptions[i] = std::current_exception();
+                }
+            });
+        for (auto &run : runs)
+            run.waitForFinished();
+
+        for (auto exception : exceptions)
+            if (exception)
+                std::rethrow_exception(exception);
+    }
+
+    {
+        QMutexLocker locker(&timesMutex);
+        modelTimes.clear();
+        for (double time : times)
+            modelTimes << time;
+    }
+
+    if (classifiers.size() == 1)
+        return modelAnnotations.front();
+
+    QList<Annotation> annotations;
+    annotations.reserve(static_cast<int>(inputs.size()));
+    for (int i=0; i<static_cast<int>(inputs.size()); i++)
+        annotations << combine(modelAnnotations, i);
+
+    return annotations;
+}
+
+/*!
+ * \brief ClassifierEnsemble::combine combines the annotations of all models for the input vector \a index.
+ * The class probabilities are averaged over the models, classes missing in a model count as 0.
+ * Multi-class models: the predicted class is the class with the highest average probability (averaging)
+ * or the class predicted by most models, ties are resolved by the average probability (voting).
+ * Multi-label models: the predicted classes are the classes with an average probability above the average threshold of the models (averaging)
+ * or the classes predicted by more than half of the models (voting). No Smell is predicted if no class is predicted.
+ */
+Annotation ClassifierEnsemble::combine(const std::vector<QList<Annotation>> &modelAnnotations, int index) const
+{
+    QMap<QString, double> probabilities;
+    QMap<QString, int> votes;
+
+    for (const auto &annotations : modelAnnotations)
+    {
+        const Annotation &annotation = annotations[index];
+
+        for (const aClass &aclass : annotation.getClasses())
+            probabilities[aclass.getName()] += aclass.getValue() / modelAnnotations.size();
+        for (const aClass &aclass : annotation.getPredClasses())
+            votes[aclass.getName()]++;
+    }
+
+    if (getIsMultiLabel())
+    {
+        QSet<aClass> classSet, predClasses;
+        double threshold = getThreshold();
+        for (auto it = probabilities.constBegin(); it != probabilities.constEnd(); it++)
+        {
+            classSet << aClass(it.key(), it.value());
+            if (it.key() == NO_SMELL_STRING)
+                continue;
+
+            bool isPredicted;
+            if (combinationMode == CombinationMode::voting)
+                isPredicted = 2 * votes.value(it.key()) > static_cast<int>(modelAnnotations.size());
+            else
+                isPredicted = it.value() > threshold;
+
+            if (isPredicted)
+                predClasses << aClass(it.key(), it.value());
+        }
+
+        if (predClasses.isEmpty())
+            predClasses << aClass(NO_SMELL_STRING);
+
+        return Annotation(classSet, predClasses);
+    }
+
+    QSet<aClass> classSet;
+    QString predName;
+    for (auto it = probabilities.constBegin(); it != probabilities.constEnd(); it++)
+    {
+        classSet << aClass(it.key(), it.value());
+
+        bool isBetter;
+        if (predName.isEmpty())
+            isBetter = true;
+        else if (combinationMode == CombinationMode::voting && votes.value(it.key()) != votes.value(predName))
+            isBetter = votes.value(it.key()) > votes.value(predName);
+        else
+            isBetter = it.value() > probabilities[predName];
+
+        if (isBetter)
+            predName = it.key();
+    }
+
+    QSet<aClass> predClasses;
+    if (!predName.isEmpty())
+        predClasses << aClass(predName, probabilities[predName]);
+
+    return Annotation(classSet, predClasses);
+}
+
+QList<double> ClassifierEnsemble::getModelTimes() const
+{
+    QMutexLocker locker(&timesMutex);
+    return modelTimes;
+}
+
+/*!
+ * \brief ClassifierEnsemble::getTimingString returns the time of each model in the last call of getAnnotations
+ */
+QString ClassifierEnsemble::getTimingString() const
+{
+    QList<double> times = getModelTimes();
+
+    QStringList timeStrings;
+    for (int i=0; i<classifiers.size() && i<times.size(); i++)
+        timeStrings << classifiers[i]->getName() + ": " + QString::number(times[i], 'f', 1) + " ms";
+
+    return timeStrings.join(", ");
+}
+
+QString ClassifierEnsemble::getName() const
+{
+    QStringList names;
+    for (auto classifier : classifiers)
+        names << classifier->getName();
+
+    return names.join(" + ");
+}
+
+/*!
+ * \brief ClassifierEnsemble::getClassNames returns the class names of all models without duplicates
+ */
+QStringList ClassifierEnsemble::getClassNames() const
+{
+    QStringList classNames;
+    for (auto classifier : classifiers)
+        for (QString className : classifier->getClassNames())
+            if (!classNames.contains(className))
+                classNames << className;
+
+    return classNames;
+}
+
+bool ClassifierEnsemble::getIsInputAbsolute() const
+{
+    Q_ASSERT(!classifiers.isEmpty());
+    return classifiers.first()->getIsInputAbsolute();
+}
+
+int ClassifierEnsemble::getN() const
+{
+    Q_ASSERT(!classifiers.isEmpty());
+    return classifiers.first()->getN();
+}
+
+int ClassifierEnsemble::getW() const
+{
+    Q_ASSERT(!classifiers.isEmpty());
+    return classifiers.first()->getW();
+}
+
+QString ClassifierEnsemble::getPresetName() const
+{
+    Q_ASSERT(!classifiers.isEmpty());
+    return classifiers.first()->getPresetName();
+}
+
+InputFunctionType ClassifierEnsemble::getInputFunctionType() const
+{
+    Q_ASSERT(!classifiers.isEmpty());
+    return classifiers.first()->getInputFunctionType();
+}
+
+bool ClassifierEnsemble::getIsMultiLabel() const
+{
+    Q_ASSERT(!classifiers.isEmpty());
+    return classifiers.first()->getIsMultiLabel();
+}
+
+/*!
+ * \brief ClassifierEnsemble::getThreshold returns the average threshold of the multi-label models
+ */
+double ClassifierEnsemble::getThreshold() const
+{
+    Q_ASSERT(!classifiers.isEmpty());
+
+    double threshold = 0.;
+    for (auto classifier : classifiers)
+        threshold += classifier->getThreshold() / classifiers.size();
+
+    return threshold;
+}
@@ -0,0 +1,79 @@
+#ifndef CLASSIFIERENSEMBLE_H
+#define CLASSIFIERENSEMBLE_H
+
+#include <QObject>
+#include <QtCore>
+
+#include <vector>
+
+#include "torchclassifier.h"
+#include "annotation.h"
+#include "classifier_definitions.h"
+
+/*!
+ * \brief The ClassifierEnsemble class runs one or more TorchClassifiers on the same input vectors.
+ * All models have to take the same inputs (N, W, input function, absolute or relative input, functionalisation preset),
+ * so the input vectors are computed once and shared. All models have to use the same output function and label mode (multi-class or multi-label),
+ * so their probabilities are comparable. The models are executed concurrently and their annotations are
+ * combined by averaging the class probabilities or by majority vote.
+ * An ensemble of a single model returns the annotations of the model unchanged.
+ */
+class ClassifierEnsemble : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class CombinationMode {averaging, voting};
+
+    explicit ClassifierEnsemble(QObject *parent = nullptr);
+    ~ClassifierEnsemble();
+
+    void addClassifier(TorchClassifier *classifier);
+
+    QList<TorchClassifier*> getClassifiers() const;
+
+    int size() const;
+
+    CombinationMode getCombinationMode() const;
+    void setCombinationMode(CombinationMode mode);
+
+    static QMap<QString, CombinationMode> getCombinationModeMap();
+
+    Annotation getAnnotation(const std::vector<double> &input);
+
+    QList<Annotation> getAnnotations(const std::vector<std::vector<double>> &inputs, int batchSize = TORCH_CLASSIFIER_DEFAULT_BATCH_SIZE);
+
+    QList<double> getModelTimes() const;
+
+    QString getTimingString() const;
+
+    QString getName() const;
+
+    QStringList getClassNames() const;
+
+    bool getIsInputAbsolute() const;
+
+    int getN() const;
+
+    int getW() const;
+
+    QString getPresetName() const;
+
+    InputFunctionType getInputFunctionType() const;
+
+    bool getIsMultiLabel() const;
+
+    double getThreshold() const;
+
+private:
+    QList<TorchClassifier*> classifiers;
+    CombinationMode combinationMode = CombinationMode::averaging;
+
+    QThreadPool pool;               // executes the models concurrently
+    mutable QMutex timesMutex;
+    QList<double> modelTimes;       // time in ms of each model in the last call of getAnnotations
+
+    Annotation combine(const std::vector<QList<Annotation>> &modelAnnotations, int index) const;
+};
+
+#endif // CLASSIFIERENSEMBLE_H
@@ -0,0 +1,102 @@
+#include "classifierinputcache.h"
+#include "functionalisationindex.h"
+
+/*!
+ * \brief ClassifierInputCache::update makes the cache contain the func vectors of all timestamps of \a data.
+ * The cache is cleared if the key changed or if cached timestamps are not the first timestamps of \a data anymore,
+ * otherwise only the func vectors of new timestamps are computed.
+ * Throws std::invalid_argument if \a inputFunctionType is not handled.
+ */
+void ClassifierInputCache::update(const QMap<uint, AbsoluteMVector> &data, const QMap<uint, AbsoluteMVector> &baseVectors, const Functionalisation &functionalisation, const std::vector<bool> &sensorFailures, InputFunctionType inputFunctionType, bool isInputAbsolute)
+{
+    if (!matches(baseVectors, functionalisation, sensorFailures, inputFunctionType, isInputAbsolute))
+    {
+        clear();
+
+        this->baseVectors.clear();
+        for (auto it = baseVectors.constBegin(); it != baseVectors.constEnd(); it++)
+            this->baseVectors[it.key()] = it.value().getVector();
+        this->functionalisation = functionalisation;
+        this->sensorFailures = sensorFailures;
+        this->inputFunctionType = inputFunctionType;
+        this->isInputAbsolute = isInputAbsolute;
+    }
+
+    // cached timestamps have to be the first timestamps of data
+    auto it = data.constBegin();
+    size_t nCached = 0;
+    while (nCached < timestamps.size() && it != data.constEnd() && it.key() == timestamps[nCached])
+    {
+        nCached++;
+        it++;
+    }
+    if (nCached < timestamps.size())
+    {
+        clear();
+        it = data.constBegin();
+    }
+
+    // compute func vectors of new timestamps
+    FunctionalisationIndex index(functionalisation, sensorFailures);
+    for (; it != data.constEnd(); it++)
+    {
+        MVector vector = isInputAbsolute ? static_cast<MVector>(it.value()) : static_cast<MVector>(it.value().getRelativeVector());
+        MVector funcVector = vector.getFuncVector(index, inputFunctionType);
+
+        if (timestamps.empty())
+            N = static_cast<int>(funcVector.getSize());
+        Q_ASSERT(static_cast<int>(funcVector.getSize()) == N);
+
+        timestamps.push_back(it.key());
+        std::vector<double> row = funcVector.getVector();
+        values.insert(values.end(), row.begin(), row.end());
+    }
+}
+
+void ClassifierInputCache::clear()
+{
+    timestamps.clear();
+    values.clear();
+    N = 0;
+}
+
+int ClassifierInputCache::size() const
+{
+    return static_cast<int>(timestamps.size());
+}
+
+int ClassifierInputCache::getN() const
+{
+    return N;
+}
+
+const std::vector<uint> &ClassifierInputCache::getTimestamps() const
+{
+    return timestamps;
+}
+
+/*!
+ * \brief ClassifierInputCache::window returns the func vectors of the rows [last-W+1, last] oldest first as one W*N vector
+ */
+std::vector<double> ClassifierInputCache::window(int last, int W) const
+{
+    Q_ASSERT(last >= W - 1 && last < size());
+
+    return std::vector<double>(values.begin() + (last - W + 1) * N, values.begin() + (last + 1) * N);
+}
+
+bool ClassifierInputCache::matches(const QMap<uint, AbsoluteMVector> &baseVectors, const Functionalisation &functionalisation, const std::vector<bool> &sensorFailures, InputFunctionType inputFunctionType, bool isInputAbsolute) const
+{
+    if (inputFunctionType != this->inputFunctionType || isInputAbsolute != this->isInputAbsolute || sensorFailures != this->sensorFailures)
+        return false;
+    if (functionalisation.size() != this->functionalisation.size() || functionalisation != this->functionalisation)
+        return false;
+
+    if (baseVectors.size() != this->baseVectors.size())
+        return false;
+    for (auto it = baseVectors.constBegin(); it != baseVectors.constEnd(); it++)
+        if (!this->baseVectors.contains(it.key()) || this->baseVectors[it.key()] != it.value().getVector())
+            return false;
+
+    return true;
+}
@@ -0,0 +1,49 @@
+#ifndef CLASSIFIERINPUTCACHE_H
+#define CLASSIFIERINPUTCACHE_H
+
+#include <QtCore>
+#include <vector>
+
+#include "mvector.h"
+#include "functionalisation.h"
+#include "classifier_definitions.h"
+
+/*!
+ * \brief The ClassifierInputCache class stores the func vectors of a measurement used as classifier input.
+ * The cache is keyed by the base vectors, functionalisation, sensor failures, input function type and absolute or relative input.
+ * While the key is unchanged, only func vectors of timestamps appended since the last update are computed,
+ * so classifying the same measurement again with another model only costs the forward passes.
+ * The func vectors are stored as consecutive rows of one matrix, so the input window of a timestamp is a contiguous slice.
+ */
+class ClassifierInputCache
+{
+public:
+    void update(const QMap<uint, AbsoluteMVector> &data, const QMap<uint, AbsoluteMVector> &baseVectors, const Functionalisation &functionalisation, const std::vector<bool> &sensorFailures, InputFunctionType inputFunctionType, bool isInputAbsolute);
+
+    void clear();
+
+    int size() const;
+
+    int getN() const;
+
+    const std::vector<uint> &getTimestamps() const;
+
+    std::vector<double> window(int last, int W) const;
+
+private:
+    // key
+    QMap<uint, std::vector<double>> baseVectors;
+    Functionalisation functionalisation;
+    std::vector<bool> sensorFailures;
+    InputFunctionType inputFunctionType = InputFunctionType::none;
+    bool isInputAbsolute = false;
+
+    // func vectors
+    std::vector<uint> timestamps;
+    std::vector<double> values;     // row i: func vector of timestamps[i], starts at i*N
+    int N = 0;
+
+    bool matches(const QMap<uint, AbsoluteMVector> &baseVectors, const Functionalisation &functionalisation, const std::vector<bool> &sensorFailures, InputFunctionType inputFunctionType, bool isInputAbsolute) const;
+};
+
+#endif // CLASSIFIERINPUTCACHE_H
@@ -11,6 +11,8 @@
 #include "../widgets/generalsettings.h"
 #include "../widgets/setsensorfailuresdialog.h"
 #include "../widgets/curvefitwizard.h"
+#include "../widgets/plotcanvas.h"
+#include "../widgets/renderscheduler.h"
 
 #include "defaultSettings.h"
 #include "datasource.h"
@@ -26,13 +28,14 @@ Controler::Controler(QObject *parent) :
 {
     // declare meta types
     qRegisterMetaType<AbsoluteMVector>("AbsoluteMVector");
+    qRegisterMetaType<std::vector<double>>("std::vector<double>");
+    qRegisterMetaType<std::vector<bool>>("std::vector<bool>");
+    qRegisterMetaType<QList<QList<double>>>("QList<QList<double>>");
+    qRegisterMetaType<QMap<uint, Annotation>>("QMap<uint, Annotation>");
 
     // parse launch arguments
     parseArguments();
 
-    // init mData
-    mData->setInputFunctionType(inputFunctionType);
-
     // eNoseColor singleton:
     // keep sensorFailures and functionalisation updated
     ENoseColor::instance().setFunctionalisation(mData->getFunctionalisation());
@@ -95,6 +98,8 @@ Controler::Controler(QObject *parent) :
     connect(mData, &MeasurementData::selectionVectorChanged, w, &MainWindow::setSelectionVector);
     connect(mData, &MeasurementData::selectionCleared, w, &MainWindow::clearSelectionVector);
 
+    // func aggregation
+    connect(mData, &MeasurementData::inputFunctionTypeChanged, w, &MainWindow::setInputFunctionType);
 
     // info widget connections:
     connect(w, &MainWindow::sensorFailureDialogRequested, [this](){
@@ -136,8 +141,48 @@ Controler::Controler(QObject *parent) :
 
     connect(w, &MainWindow::loadClassifierRequested, this, &Controler::loadClassifier);
     connect(w, &MainWindow::classifyMeasurementRequested, this, &Controler::classifyMeasurement);
+    connect(w, &MainWindow::liveClassificationRequested, this, &Controler::setLiveClassification);
 
     connect(w, &MainWindow::fitCurvesRequested, this, &Controler::fitCurves);
+    connect(w, &MainWindow::liveCurveFitRequested, this, &Controler::setLiveCurveFit);
+
+    // live curve fit:
+    // relative vectors are calculated in this thread, the fit runs in liveFitThread
+    connect(mData, &MeasurementData::vectorAdded, this, [this](uint timestamp, AbsoluteMVector vector){
+        if (liveFitWorker != nullptr)
+            QMetaObject::invokeMethod(liveFitWorker, "addVector", Qt::QueuedConnection, Q_ARG(uint, timestamp), Q_ARG(std::vector<double>, vector.getRelativeVector().getVector()));
+    });
+
+    // live classification:
+    // classifier inputs are calculated in this thread, the inference runs in liveClassificationThread
+    connect(mData, &MeasurementData::vectorAdded, this, [this](uint timestamp, AbsoluteMVector vector, Functionalisation functionalisation, std::vector<bool> sensorFailures){
+        if (liveClassificationWorker != nullptr)
+        {
+            MVector inputVector = classifier->getIsInputAbsolute() ? static_cast<MVector>(vector) : static_cast<MVector>(vector.getRelativeVector());
+            try {
+                liveWindow.push(inputVector.getFuncVector(functionalisation, sensorFailures, classifier->getInputFunctionType()).getVector());
+            } catch (std::invalid_argument& e) {
+                qWarning() << "Live classification: " << e.what();
+                return;
+            }
+
+            if (liveWindow.isFull())
+                liveClassificationWorker->enqueue(timestamp, liveWindow.window());
+        }
+    });
+    connect(mData, &MeasurementData::sensorFailuresSet, this, [this](const QMap<uint, AbsoluteMVector> &, const Functionalisation &, const std::vector<bool> &sensorFailures){
+        if (liveFitWorker != nullptr)
+            QMetaObject::invokeMethod(liveFitWorker, "setSensorFailures", Qt::QueuedConnection, Q_ARG(std::vector<bool>, sensorFailures));
+    });
+
+    // func vectors of the live window depend on the functionalisation and the sensor failures:
+    // refill the window after changes
+    connect(mData, &MeasurementData::functionalisationChanged, this, [this](){
+        liveWindow.clear();
+    });
+    connect(mData, &MeasurementData::sensorFailuresSet, this, [this](){
+        liveWindow.clear();
+    });
 
     // window state
     connect(mData, &MeasurementData::dataChangedSet, this, &Controler::setDataChanged);
@@ -147,10 +192,16 @@ Controler::Controler(QObject *parent) :
     autosaveTimer.setSingleShot(false);
     autosaveTimer.start(static_cast<int>(autosaveIntervall * 60 * 1000));
 
+    // init mData
+    mData->setInputFunctionType(loadInputFunctionType());
 }
 
 Controler::~Controler()
 {
+    stopClassification();
+    liveClassification = false;
+    updateLiveClassification();
+
     w->deleteLater();
 
     mData->deleteLater();
@@ -161,6 +212,8 @@ Controler::~Controler()
         sourceThread->deleteLater();
     if (classifier != nullptr)
         classifier->deleteLater();
+    if (liveFitWorker != nullptr)
+        liveFitWorker->deleteLater();
 }
 
 MainWindow *Controler::getWindow() const
@@ -192,7 +245,7 @@ bool Controler::dirIsWriteable(QDir dir)
 void Controler::initialize()
 {
     loadCLArguments();
-    if (!parseResult.curveFit)
+    if (!parseResult.curveFit && parseResult.exportDir.isEmpty())
         loadAutosave();
 }
 
@@ -209,13 +262,49 @@ void Controler::loadCLArguments()
             qDebug() << "Measurement file could not be loaded or is empty!";
             return;
         }
-        AutomatedFitWorker fitWorker(mData, parseResult.timeout, parseResult.nCores, parseResult.tExposition, parseResult.tRecovery, parseResult.tOffset);
+        AutomatedFitWorker fitWorker(mData, parseResult.timeout, parseResult.nCores, parseResult.tExposition, parseResult.tRecovery, parseResult.tOffset, parseResult.batched, parseResult.modelType, parseResult.useCache);
         fitWorker.fit();
 
         QFileInfo fileInfo(parseResult.filename);
         fitWorker.save(fileInfo.path() + "/" + "cf_" + fileInfo.fileName());
         QApplication::instance()->quit();
     }
+    // export graphs:
+    // the graphs of each file are rendered while the next file is loaded
+    else if (!parseResult.exportDir.isEmpty())
+    {
+        if (parseResult.filenames.isEmpty())
+            throw std::runtime_error("No files for graph export specified!");
+
+        QDir exportDir(parseResult.exportDir);
+        if (!exportDir.exists() && !QDir().mkpath(exportDir.absolutePath()))
+            throw std::runtime_error("Cannot create export directory " + parseResult.exportDir.toStdString() + "!");
+
+        bool failed = false;
+        for (QString filename : parseResult.filenames)
+        {
+            loadData(filename);
+            if (mData->getAbsoluteData().isEmpty()) {
+                qWarning().noquote() << "Measurement file" << filename << "could not be loaded or is empty!";
+                failed = true;
+                continue;
+            }
+
+            QString basePath = exportDir.absoluteFilePath(QFileInfo(filename).completeBaseName());
+            for (QString filePath : w->exportGraphs(basePath, parseResult.exportFormat, parseResult.exportSize))
+                qInfo().noquote() << "Exporting" << filePath;
+        }
+
+        // export results are collected here:
+        // the signals of the exporter are not delivered before the application quits
+        for (const auto &failure : w->waitForExports())
+        {
+            qCritical().noquote() << "Error exporting" << failure.first << ":" << failure.second;
+            failed = true;
+        }
+
+        QApplication::exit(failed ? 1 : 0);
+    }
     // load file
     else if (parseResult.filename != "")
     {
@@ -297,6 +386,24 @@ void Controler::loadSettings()
     int upperLimit = settings.value(UPPER_LIMIT_KEY, DEFAULT_UPPER_LIMIT).toInt();
 
     mData->setLimits(lowerLimit, upperLimit, useLimits);
+
+    RenderScheduler::instance().setMaxFps(settings.value(RENDER_MAX_FPS_KEY, DEFAULT_RENDER_MAX_FPS).toInt());
+}
+
+/*!
+ * \brief Controler::loadInputFunctionType returns the func aggregation of graphs and bar charts stored in the settings
+ */
+InputFunctionType Controler::loadInputFunctionType()
+{
+    QSettings settings(QCoreApplication::organizationName(), QCoreApplication::applicationName());
+    QString inputFunction = settings.value(FUNC_INPUT_FUNCTION_KEY, DEFAULT_FUNC_INPUT_FUNCTION).toString();
+
+    // func graphs need one value per func
+    auto inputFunctionTypeMap = FunctionalisationIndex::getInputFunctionTypeMap();
+    if (!inputFunctionTypeMap.contains(inputFunction) || inputFunctionTypeMap[inputFunction] == InputFunctionType::none)
+        return inputFunctionTypeMap[DEFAULT_FUNC_INPUT_FUNCTION];
+
+    return inputFunctionTypeMap[inputFunction];
 }
 
 void Controler::initSettings()
@@ -324,6 +431,9 @@ void Controler::setGeneralSettings()
     dialog.setMinVal(lowerLimit);   // min value for absolute values
     dialog.setUseLimits(useLimits);
     dialog.setPresetDir(presetDir);
+    dialog.setInputFunction(FunctionalisationIndex::getInputFunctionTypeMap().key(mData->getInputFunctionType()));
+    dialog.setPlotCanvas(PlotCanvas::getTypeMap().key(PlotCanvas::loadType()));
+    dialog.setMaxFps(RenderScheduler::instance().getMaxFps());
 
     if (dialog.exec())
     {
@@ -336,6 +446,16 @@ void Controler::setGeneralSettings()
 
         mData->setLimits(newLowerLimit, newUpperLimit, newUseLimits);
 
+        // --- func aggregation ---
+        settings.setValue(FUNC_INPUT_FUNCTION_KEY, dialog.getInputFunction());
+        mData->setInputFunctionType(loadInputFunctionType());
+
+        // --- graph canvas ---
+        // used by graphs created after the next start
+        settings.setValue(PLOT_CANVAS_KEY, dialog.getPlotCanvas());
+        settings.setValue(RENDER_MAX_FPS_KEY, dialog.getMaxFps());
+        RenderScheduler::instance().setMaxFps(dialog.getMaxFps());
+
         // get preset dir
         QString newPresetDir = dialog.getPresetDir();
 
@@ -462,6 +582,11 @@ void Controler::loadData()
 
 void Controler::loadData(QString fileName)
 {
+    stopClassification();
+    classifierInputCache.clear();
+    liveWindow.clear();
+    restartLiveCurveFit();
+
     FileReader* specificReader = nullptr;
     try {
         // use general reader to get specific reader for the format of filename
@@ -524,12 +649,21 @@ void Controler::parseArguments()
     parser.setApplicationDescription("eNoseAnnotator " + QString(GIT_VERSION));
     parser.addHelpOption();
     parser.addVersionOption();
-    parser.addPositionalArgument("filename", QCoreApplication::translate("main", "Measurement file (.csv) to open"));
+    parser.addPositionalArgument("filename", QCoreApplication::translate("main", "Measurement file (.csv) to open, several files with --export-graphs"), "[filename...]");
 
     QCommandLineOption curveFitOption(QStringList() << "curve-fit",
             QCoreApplication::translate("main", "Fit curves to exposition"));
     parser.addOption(curveFitOption);
 
+    QCommandLineOption exportGraphsOption(QStringList{"export-graphs"}, "export the graphs of all measurement files to exportDir", "exportDir");
+    parser.addOption(exportGraphsOption);
+
+    QCommandLineOption exportFormatOption(QStringList{"export-format"}, "format of exported graphs (png, jpg, svg, pdf)", "format", "png");
+    parser.addOption(exportFormatOption);
+
+    QCommandLineOption exportSizeOption(QStringList{"export-size"}, "size in pixels of exported graphs", "WxH", DEFAULT_GRAPH_EXPORT_SIZE);
+    parser.addOption(exportSizeOption);
+
     QCommandLineOption timeoutOption(QStringList{"timeout"}, "timeout in seconds for fitting process", "timeoutInS", "-1");
     parser.addOption(timeoutOption);
 
@@ -545,6 +679,16 @@ void Controler::parseArguments()
     QCommandLineOption tExpositionOption(QStringList{"t_exposition"}, "max time of recovery in seconds", "tRecovery", QString::number(CVWIZ_DEFAULT_RECOVERY_TIME));
     parser.addOption(tExpositionOption);
 
+    QCommandLineOption batchedOption(QStringList{"batched"}, "fit channels in batches with the Levenberg-Marquardt algorithm");
+    parser.addOption(batchedOption);
+
+    auto modelTypeMap = LeastSquaresFitter::getTypeMap();
+    QCommandLineOption modelOption(QStringList{"model"}, "model fitted to the exposition (" + modelTypeMap.keys().join(", ") + ")", "model", modelTypeMap.key(CVWIZ_DEFAULT_MODEL_TYPE));
+    parser.addOption(modelOption);
+
+    QCommandLineOption noCacheOption(QStringList{"no-cache"}, "refit all channels instead of restoring unchanged results from the curve fit cache");
+    parser.addOption(noCacheOption);
+
     // parse launch arguments
     parser.process(*QApplication::instance());
 
@@ -552,8 +696,24 @@ void Controler::parseArguments()
     const QStringList posArgs = parser.positionalArguments();
     if (posArgs.size() > 0)
         parseResult.filename = posArgs[0];
+    parseResult.filenames = posArgs;
 
     parseResult.curveFit = parser.isSet(curveFitOption);
+    parseResult.exportDir = parser.value(exportGraphsOption);
+    parseResult.exportFormat = parser.value(exportFormatOption).toLower();
+
+    QStringList exportSize = parser.value(exportSizeOption).toLower().split("x");
+    if (exportSize.size() == 2)
+        parseResult.exportSize = QSize(exportSize[0].toInt(), exportSize[1].toInt());
+    if (parseResult.exportSize.isEmpty())
+        throw std::runtime_error("Invalid export size \"" + parser.value(exportSizeOption).toStdString() + "\"!");
+
+    parseResult.batched = parser.isSet(batchedOption);
+    parseResult.useCache = !parser.isSet(noCacheOption);
+
+    if (!modelTypeMap.contains(parser.value(modelOption)))
+        throw std::runtime_error("Unknown model \"" + parser.value(modelOption).toStdString() + "\"!\nAvailable models: " + modelTypeMap.keys().join(", ").toStdString());
+    parseResult.modelType = modelTypeMap[parser.value(modelOption)];
 
     bool ok;
     parseResult.timeout = parser.value(timeoutOption).toInt(&ok);
@@ -605,6 +765,10 @@ void Controler::deleteAutosave()
 
 void Controler::clearData()
 {
+    stopClassification();
+    classifierInputCache.clear();
+    liveWindow.clear();
+    restartLiveCurveFit();
     mData->clear();
     w->clearGraphs();
 }
@@ -870,6 +1034,8 @@ void Controler::resetMeasurement()
         Q_ASSERT("Error: Connection is not open!" && static_cast<USBDataSource*>(source)->getSerial()->isOpen());
 
     QMetaObject::invokeMethod(source, "reset", Qt::QueuedConnection);
+    liveWindow.clear();
+    restartLiveCurveFit();
 }
 
 void Controler::reconnectMeasurement()
@@ -939,13 +1105,14 @@ void Controler::loadClassifier()
     // load classifier dir
     QString classiferPath = settings.value(CLASSIFIER_DIR_KEY, DEFAULT_CLASSIFIER_DIR).toString();
 
-    // get path to classifier
-    QString filename = QFileDialog::getOpenFileName(w, tr("Load smell classifier"), classiferPath, "TorchScript Files (*.pt)");
-    if (filename == "")
+    // get paths to classifiers:
+    // several models are loaded as an ensemble
+    QStringList filenames = QFileDialog::getOpenFileNames(w, tr("Load smell classifier"), classiferPath, "TorchScript Files (*.pt)");
+    if (filenames.isEmpty())
         return;
 
     // save classifier path
-    QStringList filePath = filename.split("/");
+    QStringList filePath = filenames.first().split("/");
     filePath.removeLast();
     settings.setValue(CLASSIFIER_DIR_KEY, filePath.join("/"));
 
@@ -954,17 +1121,30 @@ void Controler::loadClassifier()
         closeClassifier();
 
     // load new classifier
-    bool loadOk;
-    QString errorString;
-    classifier = new TorchClassifier(this, filename, &loadOk, &errorString);
+    classifier = new ClassifierEnsemble(this);
+    QString ensembleMode = settings.value(CLASSIFIER_ENSEMBLE_MODE_KEY, DEFAULT_CLASSIFIER_ENSEMBLE_MODE).toString();
+    classifier->setCombinationMode(ClassifierEnsemble::getCombinationModeMap().value(ensembleMode, ClassifierEnsemble::CombinationMode::averaging));
 
-    // loading classifier failed
-    if (!loadOk)
+    for (QString filename : filenames)
     {
-        QMessageBox::critical(w, "Error loading model", errorString);
-        closeClassifier();
-        return;
+        bool loadOk;
+        QString errorString;
+        TorchClassifier* model = new TorchClassifier(classifier, filename, &loadOk, &errorString);
+
+        try {
+            // loading classifier failed
+            if (!loadOk)
+                throw std::invalid_argument(errorString.toStdString());
+
+            classifier->addClassifier(model);
+        } catch (std::invalid_argument &e) {
+            QString title = filenames.size() > 1 ? "Error loading model " + filename : "Error loading model";
+            QMessageBox::critical(w, title, e.what());
+            closeClassifier();
+            return;
+        }
     }
+
     // store changed status to reset after adding new classes
     // loading a classifier should not change the measurement!
     bool prevChanged = mData->isChanged();
@@ -997,40 +1177,197 @@ void Controler::loadClassifier()
     QString presetName =  classifier->getPresetName();
 
     w->setClassifier(name, classNames, isInputAbsolute, presetName);
+
+    updateLiveClassification();
 }
 
 void Controler::closeClassifier()
 {
-    delete classifier;
+    // the classification workers use the classifier:
+    // stop them before deleting it
+    stopClassification();
+
+    ClassifierEnsemble *oldClassifier = classifier;
     classifier = nullptr;
+    updateLiveClassification();
+
+    delete oldClassifier;
 
     w->closeClassifier();
 }
 
+/*!
+ * \brief Controler::classifyMeasurement classifies all vectors of the measurement in a ClassificationWorker thread.
+ * Detected annotations are set in chunks while the classification is running, the progress dialog allows to cancel it.
+ * Batch size and torch thread count are read from the settings (CLASSIFIER_BATCH_SIZE_KEY, CLASSIFIER_THREADS_KEY).
+ */
 void Controler::classifyMeasurement()
 {
+    if (classifier == nullptr || classificationWorker != nullptr)
+        return;
+
+    QSettings settings(QCoreApplication::organizationName(), QCoreApplication::applicationName());
+    int batchSize = std::max(1, settings.value(CLASSIFIER_BATCH_SIZE_KEY, TORCH_CLASSIFIER_DEFAULT_BATCH_SIZE).toInt());
+    int nThreads = settings.value(CLASSIFIER_THREADS_KEY, DEFAULT_CLASSIFIER_THREADS).toInt();
+
     // get measurement data
-    QMap<uint, AbsoluteMVector> measDataMap = mData->getAbsoluteData();
+    const QMap<uint, AbsoluteMVector> &measDataMap = mData->getAbsoluteData();
+    if (measDataMap.isEmpty())
+        return;
+    auto functionalisation = mData->getFunctionalisation();
+    auto sensorFailures = mData->getSensorFailures();
+
+    // collect classifier inputs:
+    // the worker gets a snapshot, so mData is only accessed in this thread.
+    // func vectors are reused from the input cache if the measurement and input settings did not change,
+    // timestamps before the first complete window are not classified
+    std::vector<uint> timestamps;
+    std::vector<std::vector<double>> inputs;
+    timestamps.reserve(measDataMap.size());
+    inputs.reserve(measDataMap.size());
+    try {
+        classifierInputCache.update(measDataMap, mData->getBaseLevelMap(), functionalisation, sensorFailures, classifier->getInputFunctionType(), classifier->getIsInputAbsolute());
+        if (classifierInputCache.getN() != classifier->getN())
+            throw std::invalid_argument("Input vector has wrong size.");
+
+        int W = classifier->getW();
+        for (int i=W-1; i<classifierInputCache.size(); i++)
+        {
+            timestamps.push_back(classifierInputCache.getTimestamps()[i]);
+            inputs.push_back(classifierInputCache.window(i, W));
+        }
+    } catch (std::invalid_argument& e) {
+        QString error_message = e.what() + QString("\nDo you want to close the classifier?");
+        QMessageBox::StandardButton answer = QMessageBox::question(w, "Classifier error", error_message);
+        if (answer == QMessageBox::StandardButton::Yes)
+            closeClassifier();
+        return;
+    }
+    if (inputs.empty())
+        return;
+
+    // progress dialog:
+    // non-modal, so the user can keep navigating the graphs
+    classificationProgress = new QProgressDialog("Classifying measurement...", "Cancel", 0, static_cast<int>(inputs.size()), w);
+    classificationProgress->setWindowModality(Qt::NonModal);
+    classificationProgress->setMinimumDuration(500);
+    classificationProgress->setAutoClose(false);
+    classificationProgress->setAutoReset(false);
+    classificationProgress->setValue(0);
+    connect(classificationProgress, &QProgressDialog::canceled, this, &Controler::stopClassification);
+
+    // start worker
+    classificationThread = new QThread();
+    classificationWorker = new ClassificationWorker(classifier, timestamps, inputs, batchSize, nThreads);
+    classificationWorker->moveToThread(classificationThread);
+
+    // results of a stopped worker can still be queued:
+    // only apply results of the current worker
+    ClassificationWorker* worker = classificationWorker;
+    connect(worker, &ClassificationWorker::annotationsReady, this, [this, worker] (const QMap<uint, Annotation> &annotations) {
+        if (worker == classificationWorker)
+            mData->setDetectedAnnotations(annotations);
+    });
+    connect(worker, &ClassificationWorker::progress, this, [this, worker] (int nClassified, int) {
+        if (worker == classificationWorker && classificationProgress != nullptr)
+            classificationProgress->setValue(nClassified);
+    });
+    connect(worker, &ClassificationWorker::error, this, [this, worker] (QString errorString) {
+        if (worker != classificationWorker)
+            return;
+        stopClassification();
+
+        QString error_message = errorString + QString("\nDo you want to close the classifier?");
+        QMessageBox::StandardButton answer = QMessageBox::question(w, "Classifier error", error_message);
+        if (answer == QMessageBox::StandardButton::Yes)
+            closeClassifier();
+    });
+    connect(worker, &ClassificationWorker::finished, this, [this, worker] (bool) {
+        if (worker == classificationWorker)
+            stopClassification();
+    });
+
+    classificationThread->start();
+    QMetaObject::invokeMethod(classificationWorker, "start", Qt::QueuedConnection);
+}
+
+/*!
+ * \brief Controler::stopClassification cancels a running classification and waits for the worker thread.
+ * The worker stops after its current batch. Results already applied are kept.
+ */
+void Controler::stopClassification()
+{
+    if (classificationWorker == nullptr)
+        return;
+
+    classificationWorker->cancel();
+    classificationThread->quit();
+    classificationThread->wait();
+
+    delete classificationWorker;
+    delete classificationThread;
+    classificationWorker = nullptr;
+    classificationThread = nullptr;
 
-    // classify
-    for (uint timestamp : measDataMap.keys())
+    if (classificationProgress != nullptr)
     {
-        MVector vector = classifier->getIsInputAbsolute() ? static_cast<MVector>(measDataMap[timestamp]) : static_cast<MVector>(measDataMap[timestamp].getRelativeVector());
-        auto funcVector = vector.getFuncVector(mData->getFunctionalisation(), mData->getSensorFailures(), classifier->getInputFunctionType());
-        try {
-            Annotation annotation = classifier->getAnnotation(funcVector.getVector());
-            mData->setDetectedAnnotation(annotation, timestamp);
-        } catch (std::invalid_argument& e) {
-            QString error_message = e.what() + QString("\nDo you want to close the classifier?");
+        classificationProgress->disconnect(this);
+        classificationProgress->deleteLater();
+        classificationProgress = nullptr;
+    }
+}
 
-            QMessageBox::StandardButton answer = QMessageBox::question(w, "Classifier error", error_message);
-            if (answer == QMessageBox::StandardButton::Yes)
-            {
-                closeClassifier();
-            }
+void Controler::setLiveClassification(bool active)
+{
+    liveClassification = active;
+    updateLiveClassification();
+}
 
-            break;
-        }
+/*!
+ * \brief Controler::updateLiveClassification starts the live classification if a classifier is loaded and live classification is active, otherwise stops it.
+ * Vectors added to mData are classified in liveClassificationThread and the detected annotations are set as soon as they are ready.
+ */
+void Controler::updateLiveClassification()
+{
+    bool active = liveClassification && classifier != nullptr;
+
+    if (active && liveClassificationWorker == nullptr)
+    {
+        QSettings settings(QCoreApplication::organizationName(), QCoreApplication::applicationName());
+        int nThreads = settings.value(CLASSIFIER_THREADS_KEY, DEFAULT_CLASSIFIER_THREADS).toInt();
+
+        liveWindow = WindowBuffer(classifier->getW(), classifier->getN());
+
+        liveClassificationThread = new QThread();
+        liveClassificationWorker = new LiveClassificationWorker(classifier, nThreads);
+        liveClassificationWorker->moveToThread(liveClassificationThread);
+
+        connect(liveClassificationWorker, &LiveClassificationWorker::annotationsReady, mData, &MeasurementData::setDetectedAnnotations);
+        connect(liveClassificationWorker, &LiveClassificationWorker::statistics, this, [this] (double meanLatency, double maxLatency, int nClassified, int nSkipped) {
+            QString info = "Live classification: " + QString::number(meanLatency, 'f', 1) + " ms mean latency, " + QString::number(maxLatency, 'f', 1) + " ms max";
+            if (nSkipped > 0)
+                info += ", " + QString::number(nSkipped) + " of " + QString::number(nClassified + nSkipped) + " vectors skipped";
+            if (classifier != nullptr && classifier->size() > 1)
+                info += "\nModels: " + classifier->getTimingString();
+            w->setClassifierInfo(info);
+        });
+        connect(liveClassificationWorker, &LiveClassificationWorker::error, this, [this] (QString errorString) {
+            qWarning() << "Live classification: " << errorString;
+        });
+
+        liveClassificationThread->start();
+        QMetaObject::invokeMethod(liveClassificationWorker, "start", Qt::QueuedConnection);
+    }
+    else if (!active && liveClassificationWorker != nullptr)
+    {
+        // wait for the current batch, the classifier might be deleted next
+        liveClassificationThread->quit();
+        liveClassificationThread->wait();
+
+        delete liveClassificationWorker;
+        delete liveClassificationThread;
+        liveClassificationWorker = nullptr;
+        liveClassificationThread = nullptr;
     }
 }
 
@@ -1054,3 +1391,48 @@ void Controler::fitCurves()
     CurveFitWizard wizard(mData, w);
     wizard.exec();
 }
+
+/*!
+ * \brief Controler::setLiveCurveFit starts or stops the live curve fit.
+ * The fit starts with the next vector received and runs in a separate thread.
+ * \param active
+ */
+void Controler::setLiveCurveFit(bool active)
+{
+    if (active && liveFitWorker == nullptr)
+    {
+        liveFitThread = new QThread();
+        liveFitWorker = new LiveCurveFitWorker();
+        liveFitWorker->setSensorFailures(mData->getSensorFailures());
+        liveFitWorker->moveToThread(liveFitThread);
+
+        connect(liveFitWorker, SIGNAL(destroyed()), liveFitThread, SLOT(quit()));   // end thread when worker is deleted
+        connect(liveFitThread, SIGNAL(finished()), liveFitThread, SLOT(deleteLater())); // delete thread when finishes
+
+        connect(liveFitWorker, &LiveCurveFitWorker::dataSet, w, &MainWindow::setLiveFitData);
+        connect(liveFitWorker, &LiveCurveFitWorker::convergenceReached, w, &MainWindow::setLiveFitConverged);
+        connect(liveFitWorker, &LiveCurveFitWorker::error, this, [this] (QString errorString) {
+            qWarning() << "Live curve fit: " << errorString;
+        });
+
+        liveFitThread->start();
+        QMetaObject::invokeMethod(liveFitWorker, "start", Qt::QueuedConnection);
+    }
+    else if (!active && liveFitWorker != nullptr)
+    {
+        QMetaObject::invokeMethod(liveFitWorker, "stop", Qt::QueuedConnection);
+        liveFitWorker->deleteLater();
+        liveFitWorker = nullptr;
+        liveFitThread = nullptr;
+    }
+}
+
+/*!
+ * \brief Controler::restartLiveCurveFit discards the exposition of the live curve fit, if it is active.
+ * The fit restarts with the next vector received.
+ */
+void Controler::restartLiveCurveFit()
+{
+    if (liveFitWorker != nullptr)
+        QMetaObject::invokeMethod(liveFitWorker, "start", Qt::QueuedConnection);
+}
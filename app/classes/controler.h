@@ -2,14 +2,19 @@
 #define CONTROLER_H
 
 #include <QObject>
+#include <QProgressDialog>
 
 #include "../widgets/mainwindow.h"
 
 #include "measurementdata.h"
 #include "datasource.h"
 #include "mvector.h"
-#include "torchclassifier.h"
+#include "classifierensemble.h"
 #include "classifier_definitions.h"
+#include "curvefitworker.h"
+#include "classificationworker.h"
+#include "windowbuffer.h"
+#include "classifierinputcache.h"
 
 class ParseResult
 {
@@ -17,20 +22,33 @@ public:
     ParseResult() {}
 
     QString filename;
+    QStringList filenames;          // all positional arguments
     bool curveFit = false;
+    QString exportDir;              // graphs of all files are exported to exportDir, if not empty
+    QString exportFormat = "png";
+    QSize exportSize;
     int timeout = -1;
     int nCores = -1;
     int tOffset = 0;
     int tExposition = -1;
     int tRecovery = CVWIZ_DEFAULT_RECOVERY_TIME;
+    bool batched = CVWIZ_DEFAULT_BATCHED;
+    LeastSquaresFitter::Type modelType = CVWIZ_DEFAULT_MODEL_TYPE;
+    bool useCache = CVWIZ_DEFAULT_USE_CACHE;
 
     QString toString()
     {
         QString resultString;
         resultString += "filename:\t" + filename + "\n";
         resultString += "curveFit:\t" + QString::number(curveFit) + "\n";
+        resultString += "exportDir:\t" + exportDir + "\n";
+        resultString += "exportFormat:\t" + exportFormat + "\n";
+        resultString += "exportSize:\t" + QString::number(exportSize.width()) + "x" + QString::number(exportSize.height()) + "\n";
         resultString += "timeout:\t" + QString::number(timeout) + "\n";
         resultString += "nCores:\t" + QString::number(nCores) + "\n";
+        resultString += "batched:\t" + QString::number(batched) + "\n";
+        resultString += "model:\t" + LeastSquaresFitter::getTypeMap().key(modelType) + "\n";
+        resultString += "useCache:\t" + QString::number(useCache) + "\n";
 
         return resultString;
     }
@@ -77,9 +95,18 @@ private:
     MeasurementData *mData = nullptr;
     DataSource *source = nullptr;
     QThread* sourceThread = nullptr;
-    TorchClassifier *classifier = nullptr;
+    ClassifierEnsemble *classifier = nullptr;
+    LiveCurveFitWorker *liveFitWorker = nullptr;
+    QThread* liveFitThread = nullptr;
+    ClassificationWorker *classificationWorker = nullptr;
+    QThread* classificationThread = nullptr;
+    QProgressDialog* classificationProgress = nullptr;
+    bool liveClassification = true;     // live classification action of MainWindow is checked by default
+    LiveClassificationWorker *liveClassificationWorker = nullptr;
+    QThread* liveClassificationThread = nullptr;
+    WindowBuffer liveWindow;            // last W func vectors of the running measurement
+    ClassifierInputCache classifierInputCache;  // func vectors of the last classified measurement
 
-    InputFunctionType inputFunctionType = InputFunctionType::medianAverage;
     ParseResult parseResult;
 
 private slots:
@@ -97,6 +124,8 @@ private slots:
 
     void setGeneralSettings();
 
+    InputFunctionType loadInputFunctionType();
+
     void setSourceConnection();
 
     void makeSourceConnections();
@@ -124,9 +153,19 @@ private slots:
 
     void classifyMeasurement();
 
+    void stopClassification();
+
+    void setLiveClassification(bool active);
+
+    void updateLiveClassification();
+
     void updateAutosave();
 
     void fitCurves();
+
+    void setLiveCurveFit(bool active);
+
+    void restartLiveCurveFit();
 };
 
 #endif // CONTROLER_H
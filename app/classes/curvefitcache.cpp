@@ -0,0 +1,111 @@
+#include "curvefitcache.h"
+
+CurveFitCache::CurveFitCache(QString directory):
+    directory(directory)
+{
+    QDir().mkpath(directory);
+}
+
+/*!
+ * \brief CurveFitCache::defaultDirectory returns the cache location of the application or a directory in the temp path, if it is not available.
+ */
+QString CurveFitCache::defaultDirectory()
+{
+    QString cacheLocation = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (cacheLocation.isEmpty())
+        cacheLocation = QDir::tempPath() + "/" + QCoreApplication::applicationName();
+
+    return cacheLocation + "/" + CURVE_FIT_CACHE_DIR;
+}
+
+/*!
+ * \brief CurveFitCache::key calculates the key of a channel fit
+ * \param samples data range of the channel
+ * \param settings serialized settings of the fit
+ */
+QByteArray CurveFitCache::key(const std::vector<std::pair<double, double> > &samples, const QByteArray &settings)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+
+    QByteArray versionData;
+    QDataStream versionStream(&versionData, QIODevice::WriteOnly);
+    versionStream << static_cast<qint32>(CURVE_FIT_CACHE_VERSION) << static_cast<quint64>(samples.size());
+    hash.addData(versionData);
+
+    hash.addData(settings);
+    for (const auto &sample : samples)
+    {
+        hash.addData(reinterpret_cast<const char*>(&sample.first), sizeof(double));
+        hash.addData(reinterpret_cast<const char*>(&sample.second), sizeof(double));
+    }
+
+    return hash.result().toHex();
+}
+
+/*!
+ * \brief CurveFitCache::load loads the entry of \param key into \param entry
+ * \return false if there is no valid entry for key
+ */
+bool CurveFitCache::load(const QByteArray &key, CurveFitCache::Entry &entry) const
+{
+    QFile file(filePath(key));
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream in(&file);
+    qint32 version;
+    QVector<double> parameters;
+
+    in >> version;
+    if (version != CURVE_FIT_CACHE_VERSION)
+        return false;
+
+    in >> entry.fitValid >> parameters >> entry.sigmaError >> entry.tau90 >> entry.f_t90 >> entry.nSamples;
+    if (in.status() != QDataStream::Ok)
+        return false;
+
+    entry.parameters = parameters.toStdVector();
+    return true;
+}
+
+/*!
+ * \brief CurveFitCache::store stores \param entry for \param key.
+ * The file is written atomically, so concurrent loads never read a partial entry.
+ */
+void CurveFitCache::store(const QByteArray &key, const CurveFitCache::Entry &entry) const
+{
+    QSaveFile file(filePath(key));
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        qWarning() << "Unable to write curve fit cache: " << file.errorString();
+        return;
+    }
+
+    QDataStream out(&file);
+    out << static_cast<qint32>(CURVE_FIT_CACHE_VERSION);
+    out << entry.fitValid << QVector<double>::fromStdVector(entry.parameters) << entry.sigmaError << entry.tau90 << entry.f_t90 << entry.nSamples;
+
+    file.commit();
+}
+
+/*!
+ * \brief CurveFitCache::prune removes the oldest entries until at most \param maxEntries are left
+ */
+void CurveFitCache::prune(int maxEntries) const
+{
+    QDir dir(directory);
+    auto entries = dir.entryInfoList(QDir::Files, QDir::Time);
+
+    for (int i=maxEntries; i<entries.size(); i++)
+        QFile::remove(entries[i].absoluteFilePath());
+}
+
+void CurveFitCache::clear() const
+{
+    prune(0);
+}
+
+QString CurveFitCache::filePath(const QByteArray &key) const
+{
+    return directory + "/" + QString::fromLatin1(key);
+}
@@ -0,0 +1,50 @@
+#ifndef CURVEFITCACHE_H
+#define CURVEFITCACHE_H
+
+#include <vector>
+
+#include <QtCore>
+
+#define CURVE_FIT_CACHE_VERSION 1            // increase if the fitting algorithms change results
+#define CURVE_FIT_CACHE_MAX_ENTRIES 20000    // oldest entries are removed by prune()
+#define CURVE_FIT_CACHE_DIR "curvefit"
+
+/*!
+ * \brief The CurveFitCache class stores curve fit results of single channels on disk.
+ * Entries are keyed by a hash of the channel data range and all settings influencing the fit,
+ * each entry is stored in a separate file. Entries can be loaded and stored from multiple threads.
+ */
+class CurveFitCache
+{
+public:
+    struct Entry
+    {
+        bool fitValid = false;
+        std::vector<double> parameters;
+        double sigmaError = 0.;
+        double tau90 = 0.;
+        double f_t90 = 0.;
+        double nSamples = 0.;
+    };
+
+    explicit CurveFitCache(QString directory = defaultDirectory());
+
+    static QString defaultDirectory();
+
+    static QByteArray key(const std::vector<std::pair<double, double>> &samples, const QByteArray &settings);
+
+    bool load(const QByteArray &key, Entry &entry) const;
+
+    void store(const QByteArray &key, const Entry &entry) const;
+
+    void prune(int maxEntries = CURVE_FIT_CACHE_MAX_ENTRIES) const;
+
+    void clear() const;
+
+private:
+    QString directory;
+
+    QString filePath(const QByteArray &key) const;
+};
+
+#endif // CURVEFITCACHE_H
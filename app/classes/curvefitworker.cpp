@@ -1,5 +1,7 @@
 #include "curvefitworker.h"
 
+#include "fitmodelregistry.h"
+
 CurveFitWorker::CurveFitWorker(MeasurementData* mData, QObject *parent):
     QObject(parent),
     QRunnable(),
@@ -29,27 +31,35 @@ CurveFitWorker::CurveFitWorker(MeasurementData* mData, QObject *parent):
 
 void CurveFitWorker::run()
 {
-    Q_ASSERT(ch < mData->nChannels());
-
-    if (ch == 0)
-        emit started();
-
-    // select channel to be fitted
+    // select channels to be fitted:
+    // batched fits take up to batchSize channels at once
     mutex.lock();
-    size_t channel = ch;
-    ch++;
+    size_t firstChannel = ch;
+    size_t lastChannel = batched ? qMin(ch + batchSize, static_cast<size_t>(mData->nChannels())) : qMin(ch + 1, static_cast<size_t>(mData->nChannels()));
+    ch = lastChannel;
     mutex.unlock();
 
-    // fit channel
-    fitChannel(channel);
+    // all channels taken by previous runs
+    if (firstChannel >= lastChannel)
+        return;
+
+    if (firstChannel == 0)
+        emit started();
+
+    // fit channels
+    if (batched)
+        fitChannelsBatched(firstChannel, lastChannel);
+    else
+        fitChannel(firstChannel);
 
     // signal progress
     mutex.lock();
-    channelsFinished++;
+    channelsFinished += lastChannel - firstChannel;
+    bool allChannelsFinished = channelsFinished == mData->nChannels();
     emit progressChanged(channelsFinished);
     mutex.unlock();
 
-    if (channelsFinished == mData->nChannels())
+    if (allChannelsFinished)
     {
         QStringList header = getTableHeader();
         QStringList tooltips = getTooltips();
@@ -60,6 +70,17 @@ void CurveFitWorker::run()
     }
 }
 
+/*!
+ * \brief CurveFitWorker::getNRuns returns the number of times run() has to be started to fit all channels
+ */
+int CurveFitWorker::getNRuns() const
+{
+    if (!batched)
+        return mData->nChannels();
+
+    return (mData->nChannels() + batchSize - 1) / batchSize;
+}
+
 void CurveFitWorker::init()
 {
     // reset ch
@@ -67,14 +88,7 @@ void CurveFitWorker::init()
     channelsFinished = 0;
 
     // reset parameters
-    std::unique_ptr<LeastSquaresFitter> fitter;
-    switch (type) {
-    case LeastSquaresFitter::Type::SUPERPOS:
-        fitter.reset(new ADG_superpos_Fitter());
-        break;
-    default:
-        throw std::runtime_error("Unknown fitter type!");
-    }
+    std::unique_ptr<LeastSquaresFitter> fitter(LeastSquaresFitter::create(type));
 
     parameterNames = fitter->getParameterNames();
     fitTooltips = fitter->getTooltips();
@@ -91,6 +105,9 @@ void CurveFitWorker::init()
     nSamples =  std::vector<double>(nSamples.size(), 0.);
     fitValid = std::vector<bool>(fitValid.size(), true);
 
+    if (useCache)
+        cache.prune();
+
     // determine channel ranges
     determineChannelRanges();
 }
@@ -281,18 +298,18 @@ void CurveFitWorker::fitChannel(size_t channel)
         return;
     }
 
+    // inputs unchanged since the last fit: use cached result
+    if (restoreCachedResult(channel))
+    {
+        qDebug() << "Restored channel " << channel+1 << " from cache";
+        return;
+    }
+
     qDebug() << "Fitting channel " << channel+1;
 
     // init fitter
-    std::shared_ptr<LeastSquaresFitter> fitter, fitter_lm;
-    switch (type) {
-    case LeastSquaresFitter::Type::SUPERPOS:
-        fitter.reset(new ADG_superpos_Fitter());
-        fitter_lm.reset(new ADG_superpos_Fitter());
-        break;
-    default:
-        throw std::runtime_error("Unknown fitter type!");
-    }
+    std::shared_ptr<LeastSquaresFitter> fitter(LeastSquaresFitter::create(type));
+    std::shared_ptr<LeastSquaresFitter> fitter_lm(LeastSquaresFitter::create(type));
 
     auto channelData = dataRange[channel];
 //    for (auto pair : channelData)
@@ -311,14 +328,14 @@ void CurveFitWorker::fitChannel(size_t channel)
             double solve_error = fitter->residual_sum_of_sqares(channelData);
 
             fitter_lm->solve_lm(channelData, nIterations, limitFactor);
-            double solve_lm_error = fitter->residual_sum_of_sqares(channelData);
+            double solve_lm_error = fitter_lm->residual_sum_of_sqares(channelData);
 
             // validate parameters:
             // invalid results should be ignored in the fitting process,
             // however edge cases may produce invalid parameters
             double lastVal = channelData.back().second;
             bool solve_valid = fitter->parameters_valid(limitFactor * lastVal);
-            bool solve_lm_valid = fitter->parameters_valid(limitFactor * lastVal);
+            bool solve_lm_valid = fitter_lm->parameters_valid(limitFactor * lastVal);
 
             std::shared_ptr<LeastSquaresFitter> bestFitter;
             double bestError = qInf();
@@ -333,27 +350,151 @@ void CurveFitWorker::fitChannel(size_t channel)
                 bestError = solve_lm_error;
             } else {    // invalid results -> return
                 fitValid[channel] = false;
+                storeCachedResult(channel);
                 return;
             }
 
-            auto params = bestFitter->getParams();
+            setFitResult(channel, *bestFitter, bestError);
+            storeCachedResult(channel);
+        } catch (dlib::error exception) {
+            error("Error in channel " + QString::number(channel) + ": " + QString(exception.what()));
+        }
+    }
+}
+
+/*!
+ * \brief CurveFitWorker::fitChannelsBatched fits the channels [\param firstChannel; \param lastChannel) with one BatchedLeastSquaresFitter.
+ * Only the Levenberg-Marquardt algorithm is used. Channels with failures or without data range are ignored and fitValid is set to false.
+ */
+void CurveFitWorker::fitChannelsBatched(size_t firstChannel, size_t lastChannel)
+{
+    qDebug() << "Fitting channels " << firstChannel+1 << " - " << lastChannel << " (batched)";
+
+    auto sensorFailures = mData->getSensorFailures();
+
+    // collect channels to be fitted
+    std::vector<size_t> channels;
+    std::vector<std::vector<std::pair<double, double>>> channelData;
+    for (size_t channel=firstChannel; channel<lastChannel; channel++)
+    {
+        if (sensorFailures[channel] || dataRange[channel].empty())
+        {
+            fitValid[channel] = false;
+            continue;
+        }
+        if (restoreCachedResult(channel))
+            continue;
+        channels.push_back(channel);
+        channelData.push_back(dataRange[channel]);
+    }
+
+    if (channels.empty())
+        return;
+
+    try {
+        std::unique_ptr<AbstractBatchedLeastSquaresFitter> batchedFitter(AbstractBatchedLeastSquaresFitter::create(type, channelData));
+        batchedFitter->solve_lm(nIterations, limitFactor);
 
-            for (size_t i=0; i<params.size(); i++)
+        std::unique_ptr<LeastSquaresFitter> fitter(LeastSquaresFitter::create(type));
+        for (size_t i=0; i<channels.size(); i++)
+        {
+            if (!batchedFitter->isValid(i))
             {
-                parameterData[i][channel] = params[i];
+                fitValid[channels[i]] = false;
+                storeCachedResult(channels[i]);
+                continue;
             }
-            sigmaError[channel] = std::sqrt(bestError / channelData.size());
-            tau90[channel] = bestFitter->tau_90();
-            f_t90[channel] = bestFitter->f_t_90();
-            nSamples[channel] = channelData.size();
-
-            // after curve fit:
-            // recovery time
-            determineTRecovery(channel);
-        } catch (dlib::error exception) {
-            error("Error in channel " + QString::number(channel) + ": " + QString(exception.what()));
+
+            fitter->setParams(batchedFitter->getParams(i));
+            setFitResult(channels[i], *fitter, batchedFitter->residual_sum_of_sqares(i));
+            storeCachedResult(channels[i]);
         }
+    } catch (dlib::error exception) {
+        error("Error in channels " + QString::number(firstChannel) + " - " + QString::number(lastChannel-1) + ": " + QString(exception.what()));
+    }
+}
+
+/*!
+ * \brief CurveFitWorker::setFitResult stores parameters and metrics of \param fitter for \param channel
+ * \param error residual sum of squares of the fit
+ */
+void CurveFitWorker::setFitResult(size_t channel, LeastSquaresFitter &fitter, double error)
+{
+    auto params = fitter.getParams();
+
+    for (size_t i=0; i<params.size(); i++)
+    {
+        parameterData[i][channel] = params[i];
     }
+    sigmaError[channel] = std::sqrt(error / dataRange[channel].size());
+    tau90[channel] = fitter.tau_90();
+    f_t90[channel] = fitter.f_t_90();
+    nSamples[channel] = dataRange[channel].size();
+
+    // after curve fit:
+    // recovery time
+    determineTRecovery(channel);
+}
+
+/*!
+ * \brief CurveFitWorker::cacheKey returns the key of \param channel in the result cache.
+ * The key depends on the data range of the channel and all settings influencing the fit result.
+ */
+QByteArray CurveFitWorker::cacheKey(size_t channel) const
+{
+    QByteArray settings;
+    QDataStream stream(&settings, QIODevice::WriteOnly);
+    stream << static_cast<qint32>(type) << fitBuffer << jumpFactor << jumpBaseThreshold << recoveryFactor;
+    stream << detectExpositionStart << detectRecoveryStart << nIterations << limitFactor << batched;
+
+    return CurveFitCache::key(dataRange[channel], settings);
+}
+
+/*!
+ * \brief CurveFitWorker::restoreCachedResult restores the fit result of \param channel from the cache.
+ * The recovery time is not cached and determined again.
+ * \return false if caching is turned off or no result was cached for the current inputs of the channel
+ */
+bool CurveFitWorker::restoreCachedResult(size_t channel)
+{
+    if (!useCache || dataRange[channel].empty())
+        return false;
+
+    CurveFitCache::Entry entry;
+    if (!cache.load(cacheKey(channel), entry) || entry.parameters.size() != static_cast<size_t>(parameterData.size()))
+        return false;
+
+    fitValid[channel] = entry.fitValid;
+    if (!entry.fitValid)
+        return true;
+
+    for (size_t i=0; i<entry.parameters.size(); i++)
+        parameterData[i][channel] = entry.parameters[i];
+    sigmaError[channel] = entry.sigmaError;
+    tau90[channel] = entry.tau90;
+    f_t90[channel] = entry.f_t90;
+    nSamples[channel] = entry.nSamples;
+
+    determineTRecovery(channel);
+
+    return true;
+}
+
+void CurveFitWorker::storeCachedResult(size_t channel) const
+{
+    if (!useCache || dataRange[channel].empty())
+        return;
+
+    CurveFitCache::Entry entry;
+    entry.fitValid = fitValid[channel];
+    for (int i=0; i<parameterData.size(); i++)
+        entry.parameters.push_back(entry.fitValid ? parameterData[i][channel] : 0.);
+    entry.sigmaError = sigmaError[channel];
+    entry.tau90 = tau90[channel];
+    entry.f_t90 = f_t90[channel];
+    entry.nSamples = nSamples[channel];
+
+    cache.store(cacheKey(channel), entry);
 }
 
 /*!
@@ -580,6 +721,16 @@ void CurveFitWorker::setLimitFactor(const double &value)
     }
 }
 
+void CurveFitWorker::setBatched(bool value)
+{
+    batched = value;
+}
+
+void CurveFitWorker::setUseCache(bool value)
+{
+    useCache = value;
+}
+
 QStringList CurveFitWorker::getTableHeader() const
 {
     // get data from the worker and emit
@@ -720,14 +871,20 @@ std::vector<double> CurveFitWorker::getTau90() const
  * exposition starts at the start of the measurement + t_offset
  * Default (t_exposition=-1): exposition is assumed to go until the end of the measurement.
  * \param t_offset time offset until the start of the exposition
+ * \param batched fit channels in batches with BatchedLeastSquaresFitter
+ * \param type model fitted to the channels
+ * \param useCache restore results of unchanged channels from CurveFitCache
  * \param parent
  */
-AutomatedFitWorker::AutomatedFitWorker(MeasurementData *mData, int timeout, int nCores, int t_exposition, int t_recovery, int t_offset, QObject *parent):
+AutomatedFitWorker::AutomatedFitWorker(MeasurementData *mData, int timeout, int nCores, int t_exposition, int t_recovery, int t_offset, bool batched, LeastSquaresFitter::Type type, bool useCache, QObject *parent):
     QObject(parent),
     mData(mData),
     timeoutInS(timeout),
     t_exposition(t_exposition),
-    t_offset(t_offset)
+    t_offset(t_offset),
+    batched(batched),
+    type(type),
+    useCache(useCache)
 {
     auto absoluteData = mData->getAbsoluteData();
     if (absoluteData.isEmpty())
@@ -740,21 +897,30 @@ AutomatedFitWorker::AutomatedFitWorker(MeasurementData *mData, int timeout, int
     if (timeoutInS < 0)
         timeoutInS = mData->nChannels() * 10;
     // nCores: all available
-    if (nCores < 0)
-        nCores = QThread::idealThreadCount();
+    this->nCores = nCores >= 0 ? nCores : QThread::idealThreadCount();
 
     t_exposition_start = absoluteData.begin().key() + t_offset;
-    t_exposition_end = t_exposition>=0 ? t_exposition_start + t_exposition : absoluteData.end().key();
-    this->t_recovery = t_recovery>=0 ? t_recovery : absoluteData.end().key() - t_exposition_end;
+    t_exposition_end = t_exposition>=0 ? t_exposition_start + t_exposition : absoluteData.lastKey();
+    this->t_recovery = t_recovery>=0 ? t_recovery : absoluteData.lastKey() - t_exposition_end;
 }
 
 AutomatedFitWorker::~AutomatedFitWorker()
 {
+    // runs of worker might still be running after a timeout
+    QThreadPool::globalInstance()->waitForDone();
 }
 
-void AutomatedFitWorker::fit()
+/*!
+ * \brief AutomatedFitWorker::fit fits all channels in the global thread pool and waits until the fit is finished or timed out.
+ * Returns false if the fit was terminated due to the timeout.
+ * The runs of a timed out fit keep running until they are finished, the destructor waits for them.
+ */
+bool AutomatedFitWorker::fit()
 {
     worker->setT_recovery(t_recovery);
+    worker->setBatched(batched);
+    worker->setType(type);
+    worker->setUseCache(useCache);
     worker->setChannelRanges(t_exposition_start, t_exposition_end);
 
     // prepare event loop:
@@ -774,7 +940,10 @@ void AutomatedFitWorker::fit()
     qDebug() << "t_offset:\t" << QString::number(t_offset);
     qDebug() << "t_exposition:\t" << QString::number(t_exposition);
     qDebug() << "t_recovery:\t" << QString::number(t_recovery);
-    for (size_t i=0; i<mData->nChannels(); i++)
+    qDebug() << "batched:\t" << QString::number(batched);
+    qDebug() << "model:\t" << FitModelRegistry::getName(type);
+    qDebug() << "use cache:\t" << QString::number(useCache);
+    for (int i=0; i<worker->getNRuns(); i++)
         QThreadPool::globalInstance()->start(worker);
 
     // start event loop & timeout timer
@@ -782,12 +951,264 @@ void AutomatedFitWorker::fit()
     loop.exec();
 
     if(timer.isActive())
+    {
         qDebug("Curve fit terminated successfully");
-    else
-        qDebug("Error: Curve fit terminated due to timeout");
+        return true;
+    }
+
+    qDebug("Error: Curve fit terminated due to timeout");
+    return false;
 }
 
 void AutomatedFitWorker::save(QString fileName)
 {
     worker->save(fileName);
 }
+
+LiveCurveFitWorker::LiveCurveFitWorker(QObject *parent):
+    QObject(parent),
+    fitTimer(new QTimer(this)),
+    sensorFailures(MVector::nChannels, false)
+{
+    fitTimer->setSingleShot(true);
+    connect(fitTimer, &QTimer::timeout, this, &LiveCurveFitWorker::fitChannels);
+
+    reset();
+}
+
+void LiveCurveFitWorker::reset()
+{
+    y_offset = std::vector<double>(MVector::nChannels, 0.);
+    dataRange = std::vector<std::vector<std::pair<double, double>>>(MVector::nChannels, std::vector<std::pair<double, double>>());
+    params = std::vector<std::vector<double>>(MVector::nChannels, std::vector<double>());
+    sigmaError = std::vector<double>(MVector::nChannels, 0.);
+    tau90 = std::vector<double>(MVector::nChannels, 0.);
+    f_t90 = std::vector<double>(MVector::nChannels, 0.);
+    fitValid = std::vector<bool>(MVector::nChannels, false);
+    nStableFits = std::vector<int>(MVector::nChannels, 0);
+    nSkippedFits = std::vector<int>(MVector::nChannels, 0);
+
+    nSamples = 0;
+    newSamples = false;
+    convergenceSignaled = false;
+}
+
+/*!
+ * \brief LiveCurveFitWorker::start starts a new exposition with the next vector added.
+ * Called again to discard the current exposition, e.g. if the measurement is reset or cleared.
+ */
+void LiveCurveFitWorker::start()
+{
+    reset();
+    isRunning = true;
+    lastFitTimer.start();
+
+    emit dataSet(getTableHeader(), getTooltips(), getData());
+}
+
+void LiveCurveFitWorker::stop()
+{
+    isRunning = false;
+    fitTimer->stop();
+}
+
+void LiveCurveFitWorker::addVector(uint timestamp, std::vector<double> relativeVector)
+{
+    if (!isRunning)
+        return;
+
+    Q_ASSERT(relativeVector.size() == MVector::nChannels);
+
+    // first vector: start of the exposition
+    if (nSamples == 0)
+    {
+        expositionStart = timestamp;
+        y_offset = relativeVector;
+    }
+
+    for (size_t channel=0; channel<MVector::nChannels; channel++)
+        dataRange[channel].push_back(std::pair<double, double>(timestamp - expositionStart, relativeVector[channel] - y_offset[channel]));
+    nSamples++;
+    newSamples = true;
+
+    // limit the cost of each fit:
+    // long expositions are thinned out by dropping every second sample,
+    // the start of the exposition and the latest sample are kept
+    if (dataRange[0].size() > CVWIZ_LIVE_MAX_SAMPLES)
+    {
+        for (auto &channelData : dataRange)
+        {
+            size_t size = 0;
+            for (size_t i=0; i<channelData.size(); i+=2)
+                channelData[size++] = channelData[i];
+            if (channelData.size() % 2 == 0)
+                channelData[size++] = channelData.back();
+            channelData.resize(size);
+        }
+    }
+
+    // throttle fits:
+    // vectors received while waiting are fitted together
+    if (!fitTimer->isActive())
+        fitTimer->start(qMax(0, fitInterval - static_cast<int>(lastFitTimer.elapsed())));
+}
+
+/*!
+ * \brief LiveCurveFitWorker::fitChannels refits all channels with the samples received so far.
+ * Channels with a valid previous fit are refined starting from their previous parameters,
+ * the randomized multi-start fit is only used for the first fit or if the refinement becomes invalid.
+ * Channels whose randomized fit failed are skipped for the next CVWIZ_LIVE_RETRY_INTERVAL fits.
+ */
+void LiveCurveFitWorker::fitChannels()
+{
+    if (!isRunning || !newSamples)
+        return;
+    newSamples = false;
+
+    for (size_t channel=0; channel<MVector::nChannels; channel++)
+    {
+        auto &channelData = dataRange[channel];
+
+        if (sensorFailures[channel] || channelData.size() < CVWIZ_LIVE_MIN_SAMPLES)
+        {
+            fitValid[channel] = false;
+            continue;
+        }
+
+        // randomized fit failed recently:
+        // wait before retrying
+        if (nSkippedFits[channel] > 0)
+        {
+            nSkippedFits[channel]--;
+            continue;
+        }
+
+        std::unique_ptr<LeastSquaresFitter> fitter(LeastSquaresFitter::create(type));
+
+        try {
+            double lastVal = channelData.back().second;
+
+            // warm start from previous parameters
+            bool valid = !params[channel].empty() && fitter->refine_lm(channelData, params[channel], limitFactor);
+
+            // no previous fit or refinement failed:
+            // fall back to randomized fit
+            if (!valid)
+            {
+                fitter->solve_lm(channelData, nIterations, limitFactor);
+                valid = fitter->parameters_valid(limitFactor * lastVal);
+            }
+
+            if (!valid)
+            {
+                fitValid[channel] = false;
+                params[channel].clear();
+                nStableFits[channel] = 0;
+                nSkippedFits[channel] = CVWIZ_LIVE_RETRY_INTERVAL;
+                continue;
+            }
+
+            double newTau90 = fitter->tau_90();
+            double newF_t90 = fitter->f_t_90();
+
+            // convergence:
+            // tau90 and f(t90) stable for CVWIZ_LIVE_CONVERGENCE_COUNT fits
+            bool tau90Stable = std::abs(newTau90 - tau90[channel]) <= CVWIZ_LIVE_CONVERGENCE_TOLERANCE * std::abs(newTau90);
+            bool f_t90Stable = std::abs(newF_t90 - f_t90[channel]) <= CVWIZ_LIVE_CONVERGENCE_TOLERANCE * std::abs(newF_t90);
+            if (fitValid[channel] && tau90Stable && f_t90Stable)
+                nStableFits[channel]++;
+            else
+                nStableFits[channel] = 0;
+
+            params[channel] = fitter->getParams();
+            sigmaError[channel] = std::sqrt(fitter->residual_sum_of_sqares(channelData) / channelData.size());
+            tau90[channel] = newTau90;
+            f_t90[channel] = newF_t90;
+            fitValid[channel] = true;
+        } catch (dlib::error exception) {
+            emit error("Error in channel " + QString::number(channel) + ": " + QString(exception.what()));
+        }
+    }
+    lastFitTimer.restart();
+
+    emit dataSet(getTableHeader(), getTooltips(), getData());
+
+    // all valid channels converged
+    bool converged = false;
+    for (size_t channel=0; channel<MVector::nChannels; channel++)
+    {
+        if (sensorFailures[channel])
+            continue;
+        if (!fitValid[channel] || nStableFits[channel] < CVWIZ_LIVE_CONVERGENCE_COUNT)
+        {
+            converged = false;
+            break;
+        }
+        converged = true;
+    }
+    if (converged && !convergenceSignaled)
+    {
+        convergenceSignaled = true;
+        emit convergenceReached();
+    }
+}
+
+void LiveCurveFitWorker::setSensorFailures(std::vector<bool> value)
+{
+    sensorFailures = value;
+}
+
+void LiveCurveFitWorker::setFitInterval(int value)
+{
+    fitInterval = value;
+}
+
+QStringList LiveCurveFitWorker::getTableHeader() const
+{
+    QStringList header;
+
+    header << "fit valid";
+    header << "converged";
+    header << "number of\nsamples";
+    header << "sigma error\n[ % ]";
+    header << QString::fromUtf8("tau90\n[ s ]");
+    header << QString::fromUtf8("f(t90)\n[ % ]");
+
+    return header;
+}
+
+QStringList LiveCurveFitWorker::getTooltips() const
+{
+    QStringList tooltips;
+
+    tooltips << "fit valid\nsignals wether the curve fitted for the channel is valid";
+    tooltips << "converged\ntau90 and f(t90) did not change for the last " + QString::number(CVWIZ_LIVE_CONVERGENCE_COUNT) + " fits";
+    tooltips << "number of samples:\nnumber of data points since the start of the live fit";
+    tooltips << "sigma error:\nstandard deviation of the exposition data in relation to the fitted curve";
+    tooltips << "tau90:\ntime from start of the exposition until 90% of the plateau is reached";
+    tooltips << "f(t90):\n90% of the plateau height";
+
+    return tooltips;
+}
+
+QList<QList<double>> LiveCurveFitWorker::getData() const
+{
+    QList<QList<double>> resultData;
+
+    QList<double> fitValidList, convergedList, nSamplesList;
+    for (size_t channel=0; channel<MVector::nChannels; channel++)
+    {
+        fitValidList << static_cast<double>(fitValid[channel]);
+        convergedList << static_cast<double>(fitValid[channel] && nStableFits[channel] >= CVWIZ_LIVE_CONVERGENCE_COUNT);
+        nSamplesList << static_cast<double>(nSamples);
+    }
+    resultData << fitValidList;
+    resultData << convergedList;
+    resultData << nSamplesList;
+
+    resultData << QList<double>::fromVector(QVector<double>::fromStdVector(sigmaError));
+    resultData << QList<double>::fromVector(QVector<double>::fromStdVector(tau90));
+    resultData << QList<double>::fromVector(QVector<double>::fromStdVector(f_t90));
+
+    return resultData;
+}
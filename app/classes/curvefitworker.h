@@ -5,6 +5,8 @@
 #include <QtCore>
 
 #include "measurementdata.h"
+#include "batchedleastsquaresfitter.h"
+#include "curvefitcache.h"
 #include "defaultSettings.h"
 
 class CurveFitWorker: public QObject, public QRunnable
@@ -28,9 +30,12 @@ public:
 
     void setT_recovery(int value);
 
+    int getNRuns() const;
+
 public Q_SLOTS:
     void init();
     void fitChannel(size_t channel);
+    void fitChannelsBatched(size_t firstChannel, size_t lastChannel);
     void determineTRecovery(size_t channel, int tAverage=4);
     void setChannelRanges(uint start, uint end);
     void determineChannelRanges();
@@ -52,6 +57,8 @@ public Q_SLOTS:
 
     void setNIterations(const int &value);
     void setLimitFactor(const double &value);
+    void setBatched(bool value);
+    void setUseCache(bool value);
 
     QStringList getHeader() const;
     QStringList getTableHeader() const;
@@ -99,8 +106,18 @@ private:
     bool detectRecoveryStart = CVWIZ_DEFAULT_DETECT_RECOVERY_START;
     int nIterations = LEAST_SQUARES_N_FITS;
     double limitFactor = LEAST_SQUARES_LIMIT_FACTOR;
+    bool batched = CVWIZ_DEFAULT_BATCHED;
+    size_t batchSize = BATCHED_FIT_DEFAULT_BATCH_SIZE;
+    bool useCache = CVWIZ_DEFAULT_USE_CACHE;
+    CurveFitCache cache;
 
     int t_recovery = 60*CVWIZ_DEFAULT_RECOVERY_TIME;
+
+    void setFitResult(size_t channel, LeastSquaresFitter &fitter, double error);
+
+    QByteArray cacheKey(size_t channel) const;
+    bool restoreCachedResult(size_t channel);
+    void storeCachedResult(size_t channel) const;
 };
 
 class AutomatedFitWorker: public QObject
@@ -108,11 +125,11 @@ class AutomatedFitWorker: public QObject
     Q_OBJECT
 
 public:
-    explicit AutomatedFitWorker(MeasurementData *mData, int timeout=-1, int nCores=-1, int t_exposition=-1, int t_recovery=-1, int t_offset=0, QObject *parent = nullptr);
+    explicit AutomatedFitWorker(MeasurementData *mData, int timeout=-1, int nCores=-1, int t_exposition=-1, int t_recovery=-1, int t_offset=0, bool batched=CVWIZ_DEFAULT_BATCHED, LeastSquaresFitter::Type type=CVWIZ_DEFAULT_MODEL_TYPE, bool useCache=CVWIZ_DEFAULT_USE_CACHE, QObject *parent = nullptr);
     ~AutomatedFitWorker();
 
 public slots:
-    void fit();
+    bool fit();
     void save(QString fileName);
 
 protected:
@@ -122,9 +139,70 @@ protected:
     int nCores;
     int t_exposition;
     int t_offset;
+    bool batched;
+    LeastSquaresFitter::Type type;
+    bool useCache;
     uint t_exposition_start;
     uint t_exposition_end;
     uint t_recovery;
 };
 
+/*!
+ * \brief The LiveCurveFitWorker class fits the exposition curves of a running measurement.
+ * It is moved into a separate thread and fed with the relative vectors of the measurement.
+ * Each channel is refitted with the previous parameters as start values, fits are throttled to fitInterval.
+ */
+class LiveCurveFitWorker: public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit LiveCurveFitWorker(QObject *parent = nullptr);
+
+    QStringList getTableHeader() const;
+    QStringList getTooltips() const;
+    QList<QList<double>> getData() const;
+
+public Q_SLOTS:
+    void start();
+    void stop();
+    void addVector(uint timestamp, std::vector<double> relativeVector);
+    void setSensorFailures(std::vector<bool> value);
+    void setFitInterval(int value);
+
+Q_SIGNALS:
+    void dataSet(QStringList header, QStringList tooltips, QList<QList<double>> data);
+    void convergenceReached();
+    void error(QString errorMessage);
+
+private Q_SLOTS:
+    void fitChannels();
+
+private:
+    QTimer *fitTimer;
+    QElapsedTimer lastFitTimer;
+    int fitInterval = CVWIZ_LIVE_FIT_INTERVAL;
+
+    bool isRunning = false;
+    bool newSamples = false;
+    bool convergenceSignaled = false;
+    uint expositionStart = 0;
+    size_t nSamples = 0;            // number of vectors received since the start of the exposition
+
+    LeastSquaresFitter::Type type = CVWIZ_DEFAULT_MODEL_TYPE;
+    int nIterations = LEAST_SQUARES_N_FITS;
+    double limitFactor = LEAST_SQUARES_LIMIT_FACTOR;
+
+    std::vector<bool> sensorFailures;
+    std::vector<double> y_offset;
+    std::vector<std::vector<std::pair<double, double>>> dataRange;
+    std::vector<std::vector<double>> params;
+    std::vector<double> sigmaError, tau90, f_t90;
+    std::vector<bool> fitValid;
+    std::vector<int> nStableFits;
+    std::vector<int> nSkippedFits;  // number of fits the channel is skipped until its randomized fit is retried
+
+    void reset();
+};
+
 #endif // CURVEFITWORKER_H
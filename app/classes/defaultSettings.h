@@ -28,6 +28,22 @@
 #define LOWER_LIMIT_KEY "settings/lowerLimit"
 #define DEFAULT_LOWER_LIMIT 300.0
 
+// classifier
+#define CLASSIFIER_BATCH_SIZE_KEY "settings/classifierBatchSize"   // number of vectors per forward call when classifying a measurement
+#define CLASSIFIER_THREADS_KEY "settings/classifierThreads"         // torch intra-op threads of the classification worker
+#define DEFAULT_CLASSIFIER_THREADS std::max(1, QThread::idealThreadCount() - 1)
+#define CLASSIFIER_ENSEMBLE_MODE_KEY "settings/classifierEnsembleMode"  // combination of several loaded models: "average" or "vote"
+#define DEFAULT_CLASSIFIER_ENSEMBLE_MODE "average"
+
+// graphs
+#define PLOT_CANVAS_KEY "settings/plotCanvas"   // canvas of the graphs: "raster", "opengl" or "opengl_software", see PlotCanvas::getTypeMap
+#define DEFAULT_PLOT_CANVAS "raster"
+#define RENDER_MAX_FPS_KEY "settings/renderMaxFps"     // max number of replots per second of each graph
+#define DEFAULT_RENDER_MAX_FPS 30
+#define RENDER_SCHEDULER_DEBUG false    // true: the numbers of requested and executed replots are logged after each frame
+#define GRAPH_EXPORT_DPI 150            // resolution of exported graphs
+#define DEFAULT_GRAPH_EXPORT_SIZE "1600x900"    // size in pixels of graphs exported with --export-graphs
+
 // colors
 # define GRAPH_BACKGROUND_COLOR QColor(255,250,240)
 
@@ -40,10 +56,22 @@
 #define CVWIZ_DEFAULT_DETECT_EXPOSITION_START true
 #define CVWIZ_DEFAULT_DETECT_RECOVERY_START false
 #define CVWIZ_DEFAULT_RECOVERY_TIME 30
+#define CVWIZ_DEFAULT_BATCHED false     // true: channels are fitted in batches by BatchedLeastSquaresFitter
+#define CVWIZ_DEFAULT_USE_CACHE true    // true: fit results are restored from CurveFitCache if the channel data and settings did not change
 #define CVWIZ_DEBUG_MODE false  // true: curve fit executed in a single thread and additional debugging info activated
 
+// live curve fit settings
+#define CVWIZ_LIVE_FIT_INTERVAL 1000            // min time between two live fits in ms
+#define CVWIZ_LIVE_MIN_SAMPLES 10               // min number of samples in the exposition before fitting a channel
+#define CVWIZ_LIVE_CONVERGENCE_TOLERANCE 0.01   // max relative change of tau90 & f(t90) between fits of a converged channel
+#define CVWIZ_LIVE_CONVERGENCE_COUNT 5          // number of consecutive fits within the tolerance until a channel is converged
+#define CVWIZ_LIVE_MAX_SAMPLES 600              // max number of samples fitted per channel, longer expositions are thinned out
+#define CVWIZ_LIVE_RETRY_INTERVAL 10            // number of fits a channel is skipped after its randomized fit failed
+
 // functionalisation
 #define FUNC_MAX_VALUE 100000
 #define FUNC_NC_VALUE 999
+#define FUNC_INPUT_FUNCTION_KEY "settings/funcInputFunction"    // aggregation of the channels of each func in graphs and bar charts, see FunctionalisationIndex::getInputFunctionTypeMap
+#define DEFAULT_FUNC_INPUT_FUNCTION "median_average"
 
 #endif // DEFAULTVALUES_H
@@ -0,0 +1,50 @@
+#include "fitmodelregistry.h"
+
+#include <stdexcept>
+
+const QList<FitModelRegistry::Entry> &FitModelRegistry::entries()
+{
+    static const QList<Entry> registry {
+        makeEntry<ADGSuperposModel>(),
+        makeEntry<ADGSuperposDriftModel>(),
+        makeEntry<SingleExponentialModel>(),
+        makeEntry<SingleExponentialDriftModel>(),
+        makeEntry<TripleExponentialModel>(),
+        makeEntry<LangmuirModel>()
+    };
+
+    return registry;
+}
+
+const FitModelRegistry::Entry &FitModelRegistry::entry(LeastSquaresFitter::Type type)
+{
+    for (const Entry &entry : entries())
+        if (entry.type == type)
+            return entry;
+
+    throw std::invalid_argument("Fit model type is not registered!");
+}
+
+QMap<QString, LeastSquaresFitter::Type> FitModelRegistry::getTypeMap()
+{
+    QMap<QString, LeastSquaresFitter::Type> typeMap;
+    for (const Entry &entry : entries())
+        typeMap[entry.name] = entry.type;
+
+    return typeMap;
+}
+
+QString FitModelRegistry::getName(LeastSquaresFitter::Type type)
+{
+    return entry(type).name;
+}
+
+LeastSquaresFitter *FitModelRegistry::createFitter(LeastSquaresFitter::Type type)
+{
+    return entry(type).createFitter();
+}
+
+AbstractBatchedLeastSquaresFitter *FitModelRegistry::createBatchedFitter(LeastSquaresFitter::Type type, const std::vector<std::vector<std::pair<double, double> > > &channelSamples)
+{
+    return entry(type).createBatchedFitter(channelSamples);
+}
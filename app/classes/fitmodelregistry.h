@@ -0,0 +1,52 @@
+#ifndef FITMODELREGISTRY_H
+#define FITMODELREGISTRY_H
+
+#include <functional>
+#include <vector>
+
+#include <QtCore>
+
+#include "leastsquaresfitter.h"
+#include "batchedleastsquaresfitter.h"
+
+/*!
+ * \brief The FitModelRegistry class lists all fit models available in the curve fit wizard and on the command line.
+ * New models (see fitmodels.h) are added in FitModelRegistry::entries.
+ */
+class FitModelRegistry
+{
+public:
+    static QMap<QString, LeastSquaresFitter::Type> getTypeMap();
+
+    static QString getName(LeastSquaresFitter::Type type);
+
+    static LeastSquaresFitter* createFitter(LeastSquaresFitter::Type type);
+
+    static AbstractBatchedLeastSquaresFitter* createBatchedFitter(LeastSquaresFitter::Type type, const std::vector<std::vector<std::pair<double, double>>> &channelSamples);
+
+private:
+    struct Entry
+    {
+        LeastSquaresFitter::Type type;
+        QString name;
+        std::function<LeastSquaresFitter*()> createFitter;
+        std::function<AbstractBatchedLeastSquaresFitter*(const std::vector<std::vector<std::pair<double, double>>> &)> createBatchedFitter;
+    };
+
+    static const QList<Entry> &entries();
+
+    static const Entry &entry(LeastSquaresFitter::Type type);
+
+    template<class Model>
+    static Entry makeEntry()
+    {
+        return {
+            Model::type(),
+            Model::name(),
+            [](){ return new ModelFitter<Model>(); },
+            [](const std::vector<std::vector<std::pair<double, double>>> &channelSamples){ return new BatchedLeastSquaresFitter<Model>(channelSamples); }
+        };
+    }
+};
+
+#endif // FITMODELREGISTRY_H
@@ -0,0 +1,342 @@
+#ifndef FITMODELS_H
+#define FITMODELS_H
+
+#include <cmath>
+#include <QtCore>
+
+/*
+ * Response models for the curve fit.
+ *
+ * Each model declares its number of parameters at compile time and implements:
+ *  - evaluate(t, p, der):  model value at t, fills the analytic derivative if der != nullptr
+ *  - response(t, p):       model value without drift terms (used for tau90)
+ *  - plateau(p):           plateau height of the response
+ *  - startTime(p):         start value for the search of the response start
+ *  - scaleRandomParameters(p, t_first, t_last, y_max): scales random values in [0; 1) to start parameters
+ *  - parameters_valid(p, y_limit): constraints on the parameters
+ * P is any fixed size column vector type with element access p(i) (e.g. dlib::matrix<double, nParams, 1>).
+ *
+ * New models have to be registered in FitModelRegistry.
+ */
+
+enum class FitModelType {SUPERPOS, SINGLE_EXP, TRIPLE_EXP, LANGMUIR, SUPERPOS_DRIFT, SINGLE_EXP_DRIFT};
+
+/*!
+ * \brief The SingleExponentialModel struct
+ * f: alpha * (1 - e^(-beta * (t - t0)))
+ */
+struct SingleExponentialModel
+{
+    static const long nParams = 3;
+
+    static FitModelType type() { return FitModelType::SINGLE_EXP; }
+    static QString name() { return "Single exponential"; }
+    static QList<QString> parameterNames() { return {"alpha", "beta", "t0"}; }
+    static QString functionString() { return "f(t) = alpha * (1 - e^(-beta * (t - t0)))"; }
+
+    template<class P>
+    static double evaluate(double t, const P &p, P *der)
+    {
+        const double e = std::exp(-p(1) * (t - p(2)));
+
+        if (der != nullptr)
+        {
+            (*der)(0) = 1 - e;
+            (*der)(1) = p(0) * (t - p(2)) * e;
+            (*der)(2) = -p(0) * p(1) * e;
+        }
+
+        return p(0) * (1 - e);
+    }
+
+    template<class P>
+    static double response(double t, const P &p) { return evaluate(t, p, static_cast<P*>(nullptr)); }
+
+    template<class P>
+    static double plateau(const P &p) { return p(0); }
+
+    template<class P>
+    static double startTime(const P &p) { return p(2); }
+
+    template<class P>
+    static void scaleRandomParameters(P &p, double t_first, double t_last, double y_max)
+    {
+        // alpha is random in range (0; y_max)
+        p(0) = p(0) * y_max;
+        // beta is random in range (0; 2 * ln(10) / (tlast - t0))
+        p(1) = 2 * p(1) * std::log(10) / (t_last - t_first);
+        // t0 = t_first +- (0; 10)
+        p(2) = t_first + (p(2) - 0.5) * 20;
+    }
+
+    template<class P>
+    static bool parameters_valid(const P &p, double y_limit)
+    {
+        bool not_zero = !(qFuzzyIsNull(p(0)) && qFuzzyIsNull(p(1)) && qFuzzyIsNull(p(2)));
+        return not_zero && std::abs(p(0)) < y_limit && p(1) >= 0.;
+    }
+};
+
+/*!
+ * \brief The ADGSuperposModel struct implements the superposition of two "Asymptotic regression models"
+ * f: alpha_1 * (1 - e^(-beta_1 * (t - t0_1)) + alpha_2 * (1 - e^(-beta_2 * (t - t0_2))
+ */
+struct ADGSuperposModel
+{
+    static const long nParams = 6;
+
+    static FitModelType type() { return FitModelType::SUPERPOS; }
+    static QString name() { return "Exposition"; }
+    static QList<QString> parameterNames() { return {"alpha_1", "beta_1", "t0_1", "alpha_2", "beta_2", "t0_2"}; }
+    static QString functionString() { return "f(t) = alpha_1 * (1 - e^(-beta_1 * (t - t0_1))) + alpha_2 * (1 - e^(-beta_2 * (t - t0_2)))"; }
+
+    template<class P>
+    static double evaluate(double t, const P &p, P *der)
+    {
+        const double e1 = std::exp(-p(1) * (t - p(2)));
+        const double e2 = std::exp(-p(4) * (t - p(5)));
+
+        if (der != nullptr)
+        {
+            (*der)(0) = 1 - e1;
+            (*der)(1) = p(0) * (t - p(2)) * e1;
+            (*der)(2) = -p(0) * p(1) * e1;
+            (*der)(3) = 1 - e2;
+            (*der)(4) = p(3) * (t - p(5)) * e2;
+            (*der)(5) = -p(3) * p(4) * e2;
+        }
+
+        return p(0) * (1 - e1) + p(3) * (1 - e2);
+    }
+
+    template<class P>
+    static double response(double t, const P &p) { return evaluate(t, p, static_cast<P*>(nullptr)); }
+
+    template<class P>
+    static double plateau(const P &p) { return p(0) + p(3); }
+
+    template<class P>
+    static double startTime(const P &p) { return (p(2) + p(5)) / 2; }
+
+    template<class P>
+    static void scaleRandomParameters(P &p, double t_first, double t_last, double y_max)
+    {
+        // alpha is random in range (0; y_max)
+        p(0) = p(0) * y_max;
+        p(3) = p(3) * y_max;
+
+        // beta is random in range (0; 2 * ln(10) / (tlast - t0))
+        // formula is based on tau90
+        p(1) = 2 * p(1) * std::log(10) / (t_last - t_first);
+        p(4) = 2 * p(4) * std::log(10) / (t_last - t_first);
+
+        // t0 = t_first +- (0; 10)
+        p(2) = t_first + (p(2) - 0.5) * 20;
+        p(5) = t_first + (p(5) - 0.5) * 20;
+    }
+
+    template<class P>
+    static bool parameters_valid(const P &p, double y_limit)
+    {
+        // all parameters zero: fit not successfull
+        bool not_zero = false;
+        for (long i=0; i<nParams; i++)
+            not_zero = not_zero || !qFuzzyIsNull(p(i));
+
+        // alpha: plateau < y_limit
+        bool alpha_valid = std::abs(p(0) + p(3)) < y_limit;
+
+        // beta: always positive
+        bool beta_valid = p(1) >= 0. && p(4) >= 0.;
+
+        return not_zero && alpha_valid && beta_valid;
+    }
+};
+
+/*!
+ * \brief The TripleExponentialModel struct implements the superposition of three "Asymptotic regression models"
+ * f: sum_i alpha_i * (1 - e^(-beta_i * (t - t0_i)), i = 1, 2, 3
+ */
+struct TripleExponentialModel
+{
+    static const long nParams = 9;
+
+    static FitModelType type() { return FitModelType::TRIPLE_EXP; }
+    static QString name() { return "Triple exponential"; }
+    static QList<QString> parameterNames() { return {"alpha_1", "beta_1", "t0_1", "alpha_2", "beta_2", "t0_2", "alpha_3", "beta_3", "t0_3"}; }
+    static QString functionString() { return "f(t) = sum_i alpha_i * (1 - e^(-beta_i * (t - t0_i))), i = 1, 2, 3"; }
+
+    template<class P>
+    static double evaluate(double t, const P &p, P *der)
+    {
+        double value = 0.;
+        for (long i=0; i<3; i++)
+        {
+            const double e = std::exp(-p(3*i+1) * (t - p(3*i+2)));
+
+            if (der != nullptr)
+            {
+                (*der)(3*i) = 1 - e;
+                (*der)(3*i+1) = p(3*i) * (t - p(3*i+2)) * e;
+                (*der)(3*i+2) = -p(3*i) * p(3*i+1) * e;
+            }
+
+            value += p(3*i) * (1 - e);
+        }
+
+        return value;
+    }
+
+    template<class P>
+    static double response(double t, const P &p) { return evaluate(t, p, static_cast<P*>(nullptr)); }
+
+    template<class P>
+    static double plateau(const P &p) { return p(0) + p(3) + p(6); }
+
+    template<class P>
+    static double startTime(const P &p) { return (p(2) + p(5) + p(8)) / 3; }
+
+    template<class P>
+    static void scaleRandomParameters(P &p, double t_first, double t_last, double y_max)
+    {
+        for (long i=0; i<3; i++)
+        {
+            p(3*i) = p(3*i) * y_max;
+            p(3*i+1) = 2 * p(3*i+1) * std::log(10) / (t_last - t_first);
+            p(3*i+2) = t_first + (p(3*i+2) - 0.5) * 20;
+        }
+    }
+
+    template<class P>
+    static bool parameters_valid(const P &p, double y_limit)
+    {
+        bool not_zero = false;
+        for (long i=0; i<nParams; i++)
+            not_zero = not_zero || !qFuzzyIsNull(p(i));
+
+        bool alpha_valid = std::abs(plateau(p)) < y_limit;
+        bool beta_valid = p(1) >= 0. && p(4) >= 0. && p(7) >= 0.;
+
+        return not_zero && alpha_valid && beta_valid;
+    }
+};
+
+/*!
+ * \brief The LangmuirModel struct implements a Langmuir-style adsorption with second order kinetics
+ * f: alpha * beta * (t - t0) / (1 + beta * (t - t0)) for t > t0, 0 otherwise
+ */
+struct LangmuirModel
+{
+    static const long nParams = 3;
+
+    static FitModelType type() { return FitModelType::LANGMUIR; }
+    static QString name() { return "Langmuir adsorption"; }
+    static QList<QString> parameterNames() { return {"alpha", "beta", "t0"}; }
+    static QString functionString() { return "f(t) = alpha * beta * (t - t0) / (1 + beta * (t - t0))"; }
+
+    template<class P>
+    static double evaluate(double t, const P &p, P *der)
+    {
+        const double dt = t - p(2);
+
+        // no adsorption before t0
+        if (dt <= 0.)
+        {
+            if (der != nullptr)
+                *der = 0;
+            return 0.;
+        }
+
+        const double x = p(1) * dt;
+        const double denominator = (1 + x) * (1 + x);
+
+        if (der != nullptr)
+        {
+            (*der)(0) = x / (1 + x);
+            (*der)(1) = p(0) * dt / denominator;
+            (*der)(2) = -p(0) * p(1) / denominator;
+        }
+
+        return p(0) * x / (1 + x);
+    }
+
+    template<class P>
+    static double response(double t, const P &p) { return evaluate(t, p, static_cast<P*>(nullptr)); }
+
+    template<class P>
+    static double plateau(const P &p) { return p(0); }
+
+    template<class P>
+    static double startTime(const P &p) { return p(2); }
+
+    template<class P>
+    static void scaleRandomParameters(P &p, double t_first, double t_last, double y_max)
+    {
+        // alpha is random in range (0; 2 * y_max): the plateau is reached slowly
+        p(0) = 2 * p(0) * y_max;
+        // beta is random in range (0; 2 * 9 / (tlast - t0)):
+        // f(t0 + 9 / beta) = 0.9 * alpha
+        p(1) = 2 * p(1) * 9 / (t_last - t_first);
+        p(2) = t_first + (p(2) - 0.5) * 20;
+    }
+
+    template<class P>
+    static bool parameters_valid(const P &p, double y_limit)
+    {
+        bool not_zero = !(qFuzzyIsNull(p(0)) && qFuzzyIsNull(p(1)) && qFuzzyIsNull(p(2)));
+        return not_zero && std::abs(p(0)) < y_limit && p(1) > 0.;
+    }
+};
+
+/*!
+ * \brief The DriftCorrected struct adds a linear drift gamma * t to the response of Model.
+ * gamma is the last parameter, tau90 and the plateau are determined without the drift.
+ */
+template<class Model, FitModelType modelType>
+struct DriftCorrected
+{
+    static const long nParams = Model::nParams + 1;
+
+    static FitModelType type() { return modelType; }
+    static QString name() { return Model::name() + " with drift"; }
+    static QList<QString> parameterNames() { return Model::parameterNames() << "gamma"; }
+    static QString functionString() { return Model::functionString() + " + gamma * t"; }
+
+    template<class P>
+    static double evaluate(double t, const P &p, P *der)
+    {
+        if (der != nullptr)
+            (*der)(nParams-1) = t;
+
+        return Model::evaluate(t, p, der) + p(nParams-1) * t;
+    }
+
+    template<class P>
+    static double response(double t, const P &p) { return Model::response(t, p); }
+
+    template<class P>
+    static double plateau(const P &p) { return Model::plateau(p); }
+
+    template<class P>
+    static double startTime(const P &p) { return Model::startTime(p); }
+
+    template<class P>
+    static void scaleRandomParameters(P &p, double t_first, double t_last, double y_max)
+    {
+        Model::scaleRandomParameters(p, t_first, t_last, y_max);
+
+        // gamma is random in range (-0.1; 0.1) * y_max / (t_last - t_first)
+        p(nParams-1) = (p(nParams-1) - 0.5) * 0.2 * y_max / (t_last - t_first);
+    }
+
+    template<class P>
+    static bool parameters_valid(const P &p, double y_limit)
+    {
+        return Model::parameters_valid(p, y_limit);
+    }
+};
+
+typedef DriftCorrected<ADGSuperposModel, FitModelType::SUPERPOS_DRIFT> ADGSuperposDriftModel;
+typedef DriftCorrected<SingleExponentialModel, FitModelType::SINGLE_EXP_DRIFT> SingleExponentialDriftModel;
+
+#endif // FITMODELS_H
@@ -0,0 +1,333 @@
+#include "functionalisationindex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <QtGlobal>
+
+#define FUNCTIONALISATION_INDEX_STACK_SIZE 64    // funcs with more working channels are reduced in a heap buffer
+#define FUNC_MAD_SCALE 1.4826                   // MAD -> standard deviation of normally distributed values
+#define FUNC_HUBER_MAX_ITERATIONS 20
+#define FUNC_HUBER_TOLERANCE 1e-6               // relative to the Huber threshold
+
+FunctionalisationIndex::FunctionalisationIndex():
+    offsets(1, 0)
+{
+}
+
+FunctionalisationIndex::FunctionalisationIndex(const Functionalisation &functionalisation, const std::vector<bool> &sensorFailures):
+    funcs(static_cast<size_t>(functionalisation.size())),
+    sensorFailures(sensorFailures)
+{
+    Q_ASSERT(functionalisation.size() == static_cast<int>(sensorFailures.size()));
+
+    for (int i=0; i<functionalisation.size(); i++)
+        funcs[i] = functionalisation[i];
+
+    // group index of each func in ascending order of the funcs
+    std::vector<int> funcValues(funcs);
+    std::sort(funcValues.begin(), funcValues.end());
+    funcValues.erase(std::unique(funcValues.begin(), funcValues.end()), funcValues.end());
+
+    std::vector<int> groups(funcs.size());
+    offsets.assign(funcValues.size() + 1, 0);
+    for (size_t i=0; i<funcs.size(); i++)
+    {
+        groups[i] = static_cast<int>(std::lower_bound(funcValues.begin(), funcValues.end(), funcs[i]) - funcValues.begin());
+        if (!sensorFailures[i])
+            offsets[groups[i] + 1]++;
+    }
+
+    for (size_t group=1; group<offsets.size(); group++)
+        offsets[group] += offsets[group - 1];
+
+    // counting sort of the working channels by group
+    channels.resize(static_cast<size_t>(offsets.back()));
+    std::vector<int> next(offsets.begin(), offsets.end() - 1);
+    for (size_t i=0; i<funcs.size(); i++)
+        if (!sensorFailures[i])
+            channels[next[groups[i]]++] = static_cast<int>(i);
+}
+
+/*!
+ * \brief FunctionalisationIndex::cached returns the index of \a functionalisation and \a sensorFailures.
+ * The last index is kept per thread and only rebuilt if one of them changed.
+ */
+const FunctionalisationIndex &FunctionalisationIndex::cached(const Functionalisation &functionalisation, const std::vector<bool> &sensorFailures)
+{
+    thread_local FunctionalisationIndex index;
+
+    if (!index.matches(functionalisation, sensorFailures))
+        index = FunctionalisationIndex(functionalisation, sensorFailures);
+
+    return index;
+}
+
+bool FunctionalisationIndex::matches(const Functionalisation &functionalisation, const std::vector<bool> &sensorFailures) const
+{
+    if (functionalisation.size() != static_cast<int>(funcs.size()) || sensorFailures != this->sensorFailures)
+        return false;
+
+    for (size_t i=0; i<funcs.size(); i++)
+        if (funcs[i] != functionalisation[static_cast<int>(i)])
+            return false;
+
+    return true;
+}
+
+int FunctionalisationIndex::getNFuncs() const
+{
+    return static_cast<int>(offsets.size()) - 1;
+}
+
+int FunctionalisationIndex::getNChannels() const
+{
+    return static_cast<int>(funcs.size());
+}
+
+/*!
+ * \brief FunctionalisationIndex::average writes the average of the working channels of each func in \a input to \a output.
+ * \a input has getNChannels() values, \a output getNFuncs() values. Funcs without working channels are set to 0.
+ */
+void FunctionalisationIndex::average(const double *input, double *output) const
+{
+    for (int group=0; group<getNFuncs(); group++)
+    {
+        int begin = offsets[group];
+        int end = offsets[group + 1];
+
+        double sum = 0.;
+        for (int j=begin; j<end; j++)
+            sum += input[channels[j]] / (end - begin);
+
+        output[group] = sum;
+    }
+}
+
+/*!
+ * \brief FunctionalisationIndex::medianAverage writes the average of the \a nMedian median values of the working channels of each func in \a input to \a output.
+ * Funcs with nMedian or less working channels are averaged, for an odd number of surplus values the upper median values are kept.
+ * Funcs without working channels are set to 0.
+ */
+void FunctionalisationIndex::medianAverage(const double *input, double *output, int nMedian) const
+{
+    reduce(input, output, [nMedian](double *values, double *, int size) {
+        // keep the ranks [begin, end):
+        // surplus values are removed alternately from the low and the high end, starting at the low end
+        int begin = 0;
+        int end = size;
+        if (size > nMedian)
+        {
+            begin = (size - nMedian + 1) / 2;
+            end = begin + nMedian;
+            selectRanks(values, size, begin, end);
+        }
+
+        return mean(values + begin, end - begin);
+    });
+}
+
+/*!
+ * \brief FunctionalisationIndex::trimmedMean writes the mean of the working channels of each func in \a input to \a output
+ * after removing the \a fraction lowest and highest values of the func (0 <= fraction < 0.5).
+ */
+void FunctionalisationIndex::trimmedMean(const double *input, double *output, double fraction) const
+{
+    Q_ASSERT(fraction >= 0. && fraction < 0.5);
+
+    reduce(input, output, [fraction](double *values, double *, int size) {
+        int nTrim = static_cast<int>(fraction * size);
+        selectRanks(values, size, nTrim, size - nTrim);
+
+        return mean(values + nTrim, size - 2 * nTrim);
+    });
+}
+
+/*!
+ * \brief FunctionalisationIndex::huber writes the Huber M-estimate of the location of the working channels of each func in \a input to \a output.
+ * Values further than \a k robust standard deviations (1.4826 * MAD) from the estimate are down-weighted.
+ * The estimate starts at the median and is refined by iterative reweighting.
+ */
+void FunctionalisationIndex::huber(const double *input, double *output, double k) const
+{
+    reduce(input, output, [k](double *values, double *scratch, int size) {
+        double location = median(values, size);
+        double threshold = k * FUNC_MAD_SCALE * medianDeviation(values, scratch, size, location);
+        if (threshold <= 0.)
+            return location;
+
+        for (int iteration=0; iteration<FUNC_HUBER_MAX_ITERATIONS; iteration++)
+        {
+            double weightedSum = 0.;
+            double weightSum = 0.;
+            for (int i=0; i<size; i++)
+            {
+                double deviation = std::abs(values[i] - location);
+                double weight = deviation > threshold ? threshold / deviation : 1.;
+                weightedSum += weight * values[i];
+                weightSum += weight;
+            }
+
+            double newLocation = weightedSum / weightSum;
+            bool converged = std::abs(newLocation - location) < FUNC_HUBER_TOLERANCE * threshold;
+            location = newLocation;
+            if (converged)
+                break;
+        }
+
+        return location;
+    });
+}
+
+/*!
+ * \brief FunctionalisationIndex::clippedMean writes the mean of the working channels of each func in \a input to \a output
+ * after rejecting outliers further than \a threshold robust standard deviations (1.4826 * MAD) from the median of the func.
+ */
+void FunctionalisationIndex::clippedMean(const double *input, double *output, double threshold) const
+{
+    reduce(input, output, [threshold](double *values, double *scratch, int size) {
+        double center = median(values, size);
+        double maxDeviation = threshold * FUNC_MAD_SCALE * medianDeviation(values, scratch, size, center);
+
+        double sum = 0.;
+        int count = 0;
+        for (int i=0; i<size; i++)
+        {
+            if (std::abs(values[i] - center) <= maxDeviation)
+            {
+                sum += values[i];
+                count++;
+            }
+        }
+
+        return count > 0 ? sum / count : center;
+    });
+}
+
+/*!
+ * \brief FunctionalisationIndex::aggregate writes the func values of \a input to \a output using \a inputFunction.
+ * Throws std::invalid_argument for InputFunctionType::none, which keeps the channel values.
+ */
+void FunctionalisationIndex::aggregate(const double *input, double *output, InputFunctionType inputFunction, int nMedian) const
+{
+    switch (inputFunction) {
+    case InputFunctionType::average:
+        average(input, output);
+        break;
+    case InputFunctionType::medianAverage:
+        medianAverage(input, output, nMedian);
+        break;
+    case InputFunctionType::trimmedMean:
+        trimmedMean(input, output);
+        break;
+    case InputFunctionType::huber:
+        huber(input, output);
+        break;
+    case InputFunctionType::clippedMean:
+        clippedMean(input, output);
+        break;
+    default:
+        throw std::invalid_argument("Unhandled InputFunctionType!");
+    }
+}
+
+/*!
+ * \brief FunctionalisationIndex::getInputFunctionTypeMap maps the names used in settings and classifier files to the input functions
+ */
+QMap<QString, InputFunctionType> FunctionalisationIndex::getInputFunctionTypeMap()
+{
+    return QMap<QString, InputFunctionType>{
+        {"average", InputFunctionType::average},
+        {"median_average", InputFunctionType::medianAverage},
+        {"trimmed_mean", InputFunctionType::trimmedMean},
+        {"huber", InputFunctionType::huber},
+        {"clipped_mean", InputFunctionType::clippedMean},
+        {"None", InputFunctionType::none}
+    };
+}
+
+/*!
+ * \brief FunctionalisationIndex::reduce gathers the working channels of each func in \a input into a contiguous buffer
+ * and writes reduction(values, scratch, size) to \a output. Both buffers have size elements and may be reordered.
+ * Funcs without working channels are set to 0.
+ */
+template<typename Reduction>
+void FunctionalisationIndex::reduce(const double *input, double *output, Reduction reduction) const
+{
+    double stackBuffer[2 * FUNCTIONALISATION_INDEX_STACK_SIZE];
+    std::vector<double> heapBuffer;
+
+    for (int group=0; group<getNFuncs(); group++)
+    {
+        int size = offsets[group + 1] - offsets[group];
+        if (size == 0)
+        {
+            output[group] = 0.;
+            continue;
+        }
+
+        double *values = stackBuffer;
+        if (size > FUNCTIONALISATION_INDEX_STACK_SIZE)
+        {
+            heapBuffer.resize(2 * static_cast<size_t>(size));
+            values = heapBuffer.data();
+        }
+
+        for (int j=0; j<size; j++)
+            values[j] = input[channels[offsets[group] + j]];
+
+        output[group] = reduction(values, values + size, size);
+    }
+}
+
+/*!
+ * \brief FunctionalisationIndex::selectRanks moves the values of rank [begin, end) in ascending order to values[begin, end)
+ */
+void FunctionalisationIndex::selectRanks(double *values, int size, int begin, int end)
+{
+    if (begin >= end)
+        return;
+
+    std::nth_element(values, values + begin, values + size);
+    std::nth_element(values + begin, values + end - 1, values + size);
+    std::sort(values + begin, values + end);
+}
+
+/*!
+ * \brief FunctionalisationIndex::mean returns the mean of values[0, size), summed in order
+ */
+double FunctionalisationIndex::mean(const double *values, int size)
+{
+    double sum = 0.;
+    for (int i=0; i<size; i++)
+        sum += values[i] / size;
+
+    return sum;
+}
+
+/*!
+ * \brief FunctionalisationIndex::median returns the median of values[0, size), reorders the values
+ */
+double FunctionalisationIndex::median(double *values, int size)
+{
+    int upper = size / 2;
+    std::nth_element(values, values + upper, values + size);
+    if (size % 2 == 1)
+        return values[upper];
+
+    // lower middle value is the max of the lower half
+    double lower = *std::max_element(values, values + upper);
+    return (lower + values[upper]) / 2.;
+}
+
+/*!
+ * \brief FunctionalisationIndex::medianDeviation returns the median absolute deviation of values[0, size) from \a center.
+ * \a scratch has to hold size values.
+ */
+double FunctionalisationIndex::medianDeviation(const double *values, double *scratch, int size, double center)
+{
+    for (int i=0; i<size; i++)
+        scratch[i] = std::abs(values[i] - center);
+
+    return median(scratch, size);
+}
@@ -0,0 +1,63 @@
+#ifndef FUNCTIONALISATIONINDEX_H
+#define FUNCTIONALISATIONINDEX_H
+
+#include <vector>
+
+#include "functionalisation.h"
+#include "classifier_definitions.h"
+
+#define FUNC_TRIMMED_MEAN_FRACTION 0.2      // fraction of the lowest and of the highest values removed by the trimmed mean
+#define FUNC_HUBER_K 1.345                  // Huber threshold in robust standard deviations
+#define FUNC_CLIPPED_MEAN_THRESHOLD 3.0     // outlier threshold of the clipped mean in robust standard deviations
+
+/*!
+ * \brief The FunctionalisationIndex class maps the channels of a (Functionalisation, sensorFailures) pair to the functionalisations.
+ * The working channels are stored grouped by functionalisation, so func vectors are computed with one gather per group
+ * instead of QMap lookups per channel. Groups are ordered like the keys of Functionalisation::getFuncMap(sensorFailures),
+ * funcs without working channels are kept as empty groups.
+ * Besides the average, the values of each func can be reduced with the robust estimators of InputFunctionType.
+ */
+class FunctionalisationIndex
+{
+public:
+    FunctionalisationIndex();
+    FunctionalisationIndex(const Functionalisation &functionalisation, const std::vector<bool> &sensorFailures);
+
+    static const FunctionalisationIndex &cached(const Functionalisation &functionalisation, const std::vector<bool> &sensorFailures);
+
+    bool matches(const Functionalisation &functionalisation, const std::vector<bool> &sensorFailures) const;
+
+    int getNFuncs() const;
+
+    int getNChannels() const;
+
+    void average(const double *input, double *output) const;
+
+    void medianAverage(const double *input, double *output, int nMedian) const;
+
+    void trimmedMean(const double *input, double *output, double fraction = FUNC_TRIMMED_MEAN_FRACTION) const;
+
+    void huber(const double *input, double *output, double k = FUNC_HUBER_K) const;
+
+    void clippedMean(const double *input, double *output, double threshold = FUNC_CLIPPED_MEAN_THRESHOLD) const;
+
+    void aggregate(const double *input, double *output, InputFunctionType inputFunction, int nMedian = 4) const;
+
+    static QMap<QString, InputFunctionType> getInputFunctionTypeMap();
+
+private:
+    std::vector<int> funcs;             // functionalisation of each channel
+    std::vector<bool> sensorFailures;
+    std::vector<int> channels;          // working channels grouped by func, ascending within each group
+    std::vector<int> offsets;           // channels of group g: [offsets[g], offsets[g+1])
+
+    template<typename Reduction>
+    void reduce(const double *input, double *output, Reduction reduction) const;
+
+    static void selectRanks(double *values, int size, int begin, int end);
+    static double mean(const double *values, int size);
+    static double median(double *values, int size);
+    static double medianDeviation(const double *values, double *scratch, int size, double center);
+};
+
+#endif // FUNCTIONALISATIONINDEX_H
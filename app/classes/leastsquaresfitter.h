@@ -4,35 +4,44 @@
 #include <dlib/optimization.h>
 #include <QtCore>
 
+#include "defaultSettings.h"
+
 #define LEAST_SQUARES_N_FITS 20   // number of iterations
 #define LEAST_SQUARES_LIMIT_FACTOR 1.5
 #define LEAST_SQUARES_MAX_ITERATIONS 75
 
+#include "fitmodels.h"
+
 typedef dlib::matrix<double,1,1> input_vector;
-typedef dlib::matrix<double,6,1> parameter_vector;
 
 /*!
  * \brief The LeastSquaresFitter class
- * base class for fitting nonlinear functions to a given data sample with dlib
+ * base class for fitting nonlinear functions to a given data sample with dlib.
+ * The models are implemented by ModelFitter, instances are created with LeastSquaresFitter::create.
  */
 class LeastSquaresFitter
 {
 public:
-    enum class Type {SUPERPOS};
+    typedef FitModelType Type;
+
+    virtual ~LeastSquaresFitter() {}
 
-    LeastSquaresFitter();
+    static LeastSquaresFitter* create(Type type);
 
-    double model(double input) const;
+    virtual double model(double input) const = 0;
 
-    void solve(const std::vector<std::pair<double, double>>& samples, int nIterations = LEAST_SQUARES_N_FITS, double limitFactor = LEAST_SQUARES_LIMIT_FACTOR);
-    void solve_lm(const std::vector<std::pair<double, double>>& samples, int nIterations = LEAST_SQUARES_N_FITS, double limitFactor = LEAST_SQUARES_LIMIT_FACTOR);
+    virtual void solve(const std::vector<std::pair<double, double>>& samples, int nIterations = LEAST_SQUARES_N_FITS, double limitFactor = LEAST_SQUARES_LIMIT_FACTOR) = 0;
+    virtual void solve_lm(const std::vector<std::pair<double, double>>& samples, int nIterations = LEAST_SQUARES_N_FITS, double limitFactor = LEAST_SQUARES_LIMIT_FACTOR) = 0;
+    virtual bool refine_lm(const std::vector<std::pair<double, double>>& samples, const std::vector<double> &startParams, double limitFactor = LEAST_SQUARES_LIMIT_FACTOR) = 0;
 
-    double residual_sum_of_sqares(const std::vector<std::pair<double, double> > &samples) const;
+    virtual double residual_sum_of_sqares(const std::vector<std::pair<double, double> > &samples) const = 0;
 
     virtual double tau_90() = 0;
     virtual double f_t_90() = 0;
 
-    std::vector<double> getParams() const;
+    virtual std::vector<double> getParams() const = 0;
+
+    virtual void setParams(const std::vector<double> &value) = 0;
 
     QList<QString> getParameterNames() const;
 
@@ -44,71 +53,66 @@ public:
 
     static QMap<QString, LeastSquaresFitter::Type> getTypeMap();
 
-    bool parameters_valid(double y_limit) const;
+    virtual bool parameters_valid(double y_limit) const = 0;
 
-    void resetParams();
+    virtual void resetParams() = 0;
 
 protected:
-    parameter_vector params;
     QList<QString> parameterNames;
-    static QMap<QString, Type> typeMap;
-
-    double residual_sum_of_sqares(const std::vector<std::pair<double, double> > &samples, const parameter_vector &parameters) const;
-
-    virtual double model(
-        const input_vector& input_vector,
-        const parameter_vector& parameter_vector
-    ) const = 0;
-
-    virtual parameter_vector residual_derivative(
-        const std::pair<input_vector, double>& data,
-        const parameter_vector& parameter_vector
-    ) = 0;
-
-    double residual(
-        const std::pair<input_vector, double>& data,
-        const parameter_vector& params
-    ) const;
-
-    virtual parameter_vector getRandomParameterVector(const std::vector<std::pair<double, double>>& samples) const = 0;
-
-    virtual bool parameters_valid(const parameter_vector &param_vector, double y_limit) const = 0;
 };
 
 /*!
- * \brief The ADG_superpos_Fitter class
- * implements superposition of two "Asymptotic regression models"
- * f: alpha1 * (1 - e^(-beta1 * (t - t01)) + alpha2 * (1 - e^(-beta2 * (t - t02))
+ * \brief The ModelFitter class fits the model described by Model (see fitmodels.h).
+ * The parameter vector has a fixed size of Model::nParams and the model functions are called without virtual dispatch.
  */
-class ADG_superpos_Fitter : public LeastSquaresFitter
+template<class Model>
+class ModelFitter : public LeastSquaresFitter
 {
 public:
-    ADG_superpos_Fitter();
+    typedef dlib::matrix<double, Model::nParams, 1> parameter_vector;
+
+    ModelFitter();
+
+    double model(double input) const override;
+
+    void solve(const std::vector<std::pair<double, double>>& samples, int nIterations = LEAST_SQUARES_N_FITS, double limitFactor = LEAST_SQUARES_LIMIT_FACTOR) override;
+    void solve_lm(const std::vector<std::pair<double, double>>& samples, int nIterations = LEAST_SQUARES_N_FITS, double limitFactor = LEAST_SQUARES_LIMIT_FACTOR) override;
+    bool refine_lm(const std::vector<std::pair<double, double>>& samples, const std::vector<double> &startParams, double limitFactor = LEAST_SQUARES_LIMIT_FACTOR) override;
+
+    double residual_sum_of_sqares(const std::vector<std::pair<double, double> > &samples) const override;
 
     double tau_90() override;
     double f_t_90() override;
 
-    Type type() const { return Type::SUPERPOS; }
+    std::vector<double> getParams() const override;
 
-    virtual QString getFunctionString() const override;
+    void setParams(const std::vector<double> &value) override;
 
-protected:
-    double model(
-        const input_vector& input_vector,
-        const parameter_vector& parameter_vector
-    ) const;
+    QString getFunctionString() const override { return Model::functionString(); }
 
+    Type type() const override { return Model::type(); }
 
-    parameter_vector residual_derivative(
-        const std::pair<input_vector, double>& data,
-        const parameter_vector& parameter_vector
-    );
+    bool parameters_valid(double y_limit) const override;
+
+    void resetParams() override;
+
+private:
+    parameter_vector params;
+
+    template<class Solver>
+    void solve_random(Solver solver, const std::vector<std::pair<double, double>>& samples, int nIterations, double limitFactor);
+
+    static std::vector<std::pair<input_vector, double>> toSampleVector(const std::vector<std::pair<double, double>>& samples);
+
+    double residual_sum_of_sqares(const std::vector<std::pair<double, double> > &samples, const parameter_vector &parameters) const;
 
     parameter_vector getRandomParameterVector(const std::vector<std::pair<double, double>>& samples) const;
 
-    virtual bool parameters_valid(const parameter_vector &param_vector, double y_limit) const override;
+    static QString toString(const parameter_vector &parameters);
 };
 
+typedef ModelFitter<ADGSuperposModel> ADG_superpos_Fitter;
+
 class LinearFitter
 {
 public:
@@ -127,4 +131,302 @@ private:
     double m = 0., b = 0., stdDev = 0.;
 };
 
+template<class Model>
+ModelFitter<Model>::ModelFitter():
+    LeastSquaresFitter()
+{
+    params = 1;
+    parameterNames = Model::parameterNames();
+}
+
+template<class Model>
+double ModelFitter<Model>::model(double input) const
+{
+    return Model::evaluate(input, params, static_cast<parameter_vector*>(nullptr));
+}
+
+template<class Model>
+void ModelFitter<Model>::solve(const std::vector<std::pair<double, double> > &samples, int nIterations, double limitFactor)
+{
+    if (CVWIZ_DEBUG_MODE)
+        qDebug() << "solve";
+
+    solve_random([](const std::vector<std::pair<input_vector, double>>& sample_vector, parameter_vector &temp_params)
+    {
+        dlib::solve_least_squares(
+                    dlib::objective_delta_stop_strategy(1e-7, LEAST_SQUARES_MAX_ITERATIONS),
+                    [](const std::pair<input_vector, double>& data, const parameter_vector& params) -> double
+                      { return Model::evaluate(data.first(0), params, static_cast<parameter_vector*>(nullptr)) - data.second;},
+                    [](const std::pair<input_vector, double>& data, const parameter_vector& params) -> parameter_vector
+                      { parameter_vector der; Model::evaluate(data.first(0), params, &der); return der;},
+                    sample_vector,
+                    temp_params
+        );
+    }, samples, nIterations, limitFactor);
+}
+
+template<class Model>
+void ModelFitter<Model>::solve_lm(const std::vector<std::pair<double, double> > &samples, int nIterations, double limitFactor)
+{
+    if (CVWIZ_DEBUG_MODE)
+        qDebug() << "solve_lm";
+
+    solve_random([](const std::vector<std::pair<input_vector, double>>& sample_vector, parameter_vector &temp_params)
+    {
+        dlib::solve_least_squares_lm(
+                    dlib::objective_delta_stop_strategy(1e-7, LEAST_SQUARES_MAX_ITERATIONS),
+                    [](const std::pair<input_vector, double>& data, const parameter_vector& params) -> double
+                      { return Model::evaluate(data.first(0), params, static_cast<parameter_vector*>(nullptr)) - data.second;},
+                    [](const std::pair<input_vector, double>& data, const parameter_vector& params) -> parameter_vector
+                      { parameter_vector der; Model::evaluate(data.first(0), params, &der); return der;},
+                    sample_vector,
+                    temp_params
+        );
+    }, samples, nIterations, limitFactor);
+}
+
+/*!
+ * \brief ModelFitter::solve_random runs \param solver \param nIterations times from random start parameters and keeps the best valid result.
+ */
+template<class Model>
+template<class Solver>
+void ModelFitter<Model>::solve_random(Solver solver, const std::vector<std::pair<double, double> > &samples, int nIterations, double limitFactor)
+{
+    // find y_max
+    double y_max = 0.;
+    for (auto pair : samples)
+    {
+        if (pair.second > y_max)
+            y_max = pair.second;
+    }
+
+    auto sample_vector = toSampleVector(samples);
+
+    double bestError = std::numeric_limits<double>::infinity();
+    parameter_vector best_parameters;
+    best_parameters = 0;
+    for (int i=0; i<nIterations; i++)
+    {
+        parameter_vector temp_params = getRandomParameterVector(samples);
+
+        // start solver
+        solver(sample_vector, temp_params);
+
+        double error = residual_sum_of_sqares(samples, temp_params);
+
+        // check parameters
+        // skip if invalid
+        if (!Model::parameters_valid(temp_params, limitFactor * y_max))
+        {
+            if (CVWIZ_DEBUG_MODE)
+                qDebug() << "\n!Parameters invalid!\n" << toString(temp_params) << "\n\t-> result ignored";
+            continue;
+        }
+
+        if (error < bestError)
+        {
+            if (CVWIZ_DEBUG_MODE) {
+                qDebug() << "\n!Improved error from " << QString::number(bestError) << " to " << QString::number(error) << "!";
+                qDebug() << toString(temp_params);
+            }
+            bestError = error;
+            best_parameters = temp_params;
+        }
+    }
+    params = best_parameters;
+    if (CVWIZ_DEBUG_MODE) {
+        qDebug() << "-> Best error:\t" << QString::number(bestError);
+        qDebug() << toString(params);
+    }
+}
+
+/*!
+ * \brief ModelFitter::refine_lm runs a single Levenberg-Marquardt fit starting from \param startParams instead of random parameters.
+ * Used to warm start consecutive fits of a growing sample set.
+ * params are only replaced if the result is valid.
+ * \return true if the fit produced valid parameters
+ */
+template<class Model>
+bool ModelFitter<Model>::refine_lm(const std::vector<std::pair<double, double> > &samples, const std::vector<double> &startParams, double limitFactor)
+{
+    Q_ASSERT(startParams.size() == static_cast<size_t>(Model::nParams));
+
+    // find y_max
+    double y_max = 0.;
+    for (auto pair : samples)
+    {
+        if (pair.second > y_max)
+            y_max = pair.second;
+    }
+
+    auto sample_vector = toSampleVector(samples);
+
+    parameter_vector temp_params;
+    for (long i=0; i<Model::nParams; i++)
+        temp_params(i) = startParams[i];
+
+    dlib::solve_least_squares_lm(
+                dlib::objective_delta_stop_strategy(1e-7, LEAST_SQUARES_MAX_ITERATIONS),
+                [](const std::pair<input_vector, double>& data, const parameter_vector& params) -> double
+                  { return Model::evaluate(data.first(0), params, static_cast<parameter_vector*>(nullptr)) - data.second;},
+                [](const std::pair<input_vector, double>& data, const parameter_vector& params) -> parameter_vector
+                  { parameter_vector der; Model::evaluate(data.first(0), params, &der); return der;},
+                sample_vector,
+                temp_params
+    );
+
+    if (!Model::parameters_valid(temp_params, limitFactor * y_max))
+        return false;
+
+    params = temp_params;
+    return true;
+}
+
+template<class Model>
+double ModelFitter<Model>::residual_sum_of_sqares(const std::vector<std::pair<double, double> > &samples) const
+{
+    return residual_sum_of_sqares(samples, params);
+}
+
+template<class Model>
+double ModelFitter<Model>::residual_sum_of_sqares(const std::vector<std::pair<double, double> > &samples, const parameter_vector &parameters) const
+{
+    double sum = 0.;
+    for (std::pair<double, double> sample : samples)
+    {
+        double res = Model::evaluate(sample.first, parameters, static_cast<parameter_vector*>(nullptr)) - sample.second;
+        sum += res*res;
+    }
+
+    return sum;
+}
+
+/*!
+ * \brief ModelFitter::tau_90
+ * find t_zero: min(abs(f(t))) @ t = t_zero
+ * find t_90: min(abs(f(t)-0.9*plateau)) @ t = t_90
+ * tau_90 = t_90 - t_zero
+ * drift terms of the model are ignored
+ */
+template<class Model>
+double ModelFitter<Model>::tau_90()
+{
+    double t_zero = Model::startTime(params);
+
+    dlib::find_min_single_variable(
+        [this](const double input) -> double
+        {
+            return std::abs(Model::response(input, params));
+        },
+        t_zero
+    );
+
+    double t_90 = Model::startTime(params);
+    double f_90 = f_t_90();
+
+    dlib::find_min_single_variable(
+        [this, f_90](const double input) -> double
+        {
+            return std::abs(Model::response(input, params) - f_90);
+        },
+        t_90
+    );
+
+    return t_90 - t_zero;
+}
+
+template<class Model>
+double ModelFitter<Model>::f_t_90()
+{
+    return 0.9 * Model::plateau(params);
+}
+
+template<class Model>
+std::vector<double> ModelFitter<Model>::getParams() const
+{
+    std::vector<double> param_vector;
+
+    for (long i=0; i < Model::nParams; i++)
+        param_vector.push_back(params(i));
+
+    return param_vector;
+}
+
+template<class Model>
+void ModelFitter<Model>::setParams(const std::vector<double> &value)
+{
+    Q_ASSERT(value.size() == static_cast<size_t>(Model::nParams));
+
+    for (long i=0; i < Model::nParams; i++)
+        params(i) = value[i];
+}
+
+/*!
+ * \brief ModelFitter::parameters_valid is used to specify constraints on the model parameters.
+ * During the fitting process this function is called to skip invalid result parameters.
+ */
+template<class Model>
+bool ModelFitter<Model>::parameters_valid(double y_limit) const
+{
+    return Model::parameters_valid(params, y_limit);
+}
+
+template<class Model>
+void ModelFitter<Model>::resetParams()
+{
+    params = 0;
+}
+
+template<class Model>
+std::vector<std::pair<input_vector, double> > ModelFitter<Model>::toSampleVector(const std::vector<std::pair<double, double> > &samples)
+{
+    std::vector<std::pair<input_vector, double>> sample_vector;
+    sample_vector.reserve(samples.size());
+    for (std::pair<double, double> sample : samples)
+    {
+        input_vector input;
+        input(0) = sample.first;
+
+        sample_vector.push_back(std::pair<input_vector, double>(input, sample.second));
+    }
+
+    return sample_vector;
+}
+
+template<class Model>
+typename ModelFitter<Model>::parameter_vector ModelFitter<Model>::getRandomParameterVector(const std::vector<std::pair<double, double> > &samples) const
+{
+    parameter_vector parameters = dlib::randm(Model::nParams, 1);
+
+    // determine helper parameters
+    double t_first = std::numeric_limits<double>::infinity();
+    double t_last = 0.;
+    double y_max = 0.;
+
+    for (auto pair : samples)
+    {
+        if (pair.first < t_first)
+            t_first = pair.first;
+        if (pair.first > t_last)
+            t_last = pair.first;
+        if (pair.second > y_max)
+            y_max = pair.second;
+    }
+
+    Model::scaleRandomParameters(parameters, t_first, t_last, y_max);
+
+    return parameters;
+}
+
+template<class Model>
+QString ModelFitter<Model>::toString(const parameter_vector &parameters)
+{
+    QStringList list;
+    auto names = Model::parameterNames();
+    for (long i=0; i<Model::nParams; i++)
+        list << names[i] + " = " + QString::number(parameters(i));
+
+    return list.join("\t");
+}
+
 #endif // LEASTSQUARESFITTER_H
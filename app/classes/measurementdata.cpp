@@ -52,15 +52,18 @@ QMap<uint, RelativeMVector> MeasurementData::getRelativeData()
 
 QMap<uint, RelativeMVector>MeasurementData::getFuncData()
 {
+    FunctionalisationIndex index(functionalisation, sensorFailures);
+
     // only one func set
     // -> return full relative data
-    if (functionalisation.getFuncMap(sensorFailures).size() == 1)
+    if (index.getNFuncs() == 1)
         return getRelativeData();
 
-    QMap<uint, RelativeMVector> relativeData = getRelativeData();
+    // data is ordered by timestamp:
+    // append in order with the index built once
     QMap<uint, RelativeMVector> funcData;
-    for (int timestamp : relativeData.keys())
-        funcData[timestamp] = relativeData[timestamp].getFuncVector(functionalisation, sensorFailures, inputFunctionType);
+    for (auto it = data.constBegin(); it != data.constEnd(); it++)
+        funcData.insert(funcData.constEnd(), it.key(), it.value().getRelativeVector().getFuncVector(index, inputFunctionType));
 
     return funcData;
 }
@@ -571,8 +574,8 @@ void MeasurementData::saveSelectionVector(QString filePath, bool saveFunc)
 
     if (saveFunc)
     {
-        stdDevVector = stdDevVector.getFuncVector(functionalisation, sensorFailures);
-        selectionVector = selectionVector.getFuncVector(functionalisation, sensorFailures);
+        stdDevVector = stdDevVector.getFuncVector(functionalisation, sensorFailures, inputFunctionType);
+        selectionVector = selectionVector.getFuncVector(functionalisation, sensorFailures, inputFunctionType);
     }
 
     QFile file(filePath);
@@ -1037,6 +1040,30 @@ void MeasurementData::setDetectedAnnotation(Annotation annotation, uint timestam
     emit annotationsChanged(changedMap, false);
 }
 
+void MeasurementData::setDetectedAnnotations(const QMap<uint, Annotation> &annotations)
+{
+    QMap<uint, Annotation> changedMap;
+
+    for (auto it = annotations.constBegin(); it != annotations.constEnd(); it++)
+    {
+        // timestamps removed since the annotations were created are ignored
+        if (!data.contains(it.key()))
+            continue;
+
+        data[it.key()].detectedAnnotation = it.value();
+        if (selectedData.contains(it.key()))
+            selectedData[it.key()].detectedAnnotation = it.value();
+
+        changedMap.insert(changedMap.constEnd(), it.key(), it.value());
+    }
+
+    if (changedMap.isEmpty())
+        return;
+
+    setDataChanged(true);
+    emit annotationsChanged(changedMap, false);
+}
+
 void MeasurementData::setDetectedAnnotationOfSelection(Annotation annotation)
 {
     QMap<uint, Annotation> changedMap;
@@ -1228,9 +1255,30 @@ void MeasurementData::resetNChannels(size_t channels)
     emit functionalisationChanged();
 }
 
+InputFunctionType MeasurementData::getInputFunctionType() const
+{
+    return inputFunctionType;
+}
+
+/*!
+ * \brief MeasurementData::setInputFunctionType sets the aggregation of the channels of each func.
+ * Func graphs and the func vector of the selection are updated.
+ */
 void MeasurementData::setInputFunctionType(const InputFunctionType &value)
 {
+    if (value == inputFunctionType)
+        return;
+
     inputFunctionType = value;
+    emit inputFunctionTypeChanged(inputFunctionType, data, functionalisation, sensorFailures);
+
+    if (!selectedData.isEmpty())
+    {
+        AbsoluteMVector stdDevVector;
+        stdDevVector.setBaseVector(selectedData.first().getBaseVector());
+        auto selectionVector = getAbsoluteSelectionVector(&stdDevVector);
+        emit selectionVectorChanged(selectionVector, stdDevVector, sensorFailures, functionalisation);
+    }
 }
 
 /*!
@@ -192,6 +192,12 @@ public:
      */
     void setDetectedAnnotation(Annotation annotation, uint timestamp);
 
+    /*
+     * set the detected classes of all timestamps in annotations,
+     * annotationsChanged is emitted once
+     */
+    void setDetectedAnnotations(const QMap<uint, Annotation> &annotations);
+
     static QString getTimestampStringFromUInt(uint timestamp);
     static uint getTimestampUIntfromString (QString string);
 
@@ -204,6 +210,7 @@ public:
 
     QMap<uint, AbsoluteMVector> getBaseLevelMap() const;
 
+    InputFunctionType getInputFunctionType() const;
     void setInputFunctionType(const InputFunctionType &value);
 
     uint getNextTimestamp (uint timestamp);
@@ -279,6 +286,8 @@ signals:
 
     void functionalisationChanged();
 
+    void inputFunctionTypeChanged(InputFunctionType inputFunctionType, const QMap<uint, AbsoluteMVector> &data, const Functionalisation &functionalisation, const std::vector<bool> &sensorFailures);
+
 private:
     QMap<uint, AbsoluteMVector> data;  // map containing vectors of measurements with timestamps as keys
     QMap<uint, AbsoluteMVector> selectedData;
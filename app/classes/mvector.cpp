@@ -244,33 +244,7 @@ MVector MVector::getFuncAverageVector(const Functionalisation &functionalisation
     Q_ASSERT(functionalisation.size() == this->size);
     Q_ASSERT(sensorFailures.size() == this->size);
 
-    // get func map
-    auto funcMap = functionalisation.getFuncMap(sensorFailures);
-
-    // no funcs set:
-    // return relativevector
-    if (funcMap.size() == 1)
-        return *this;
-
-    // init func vector
-    RelativeMVector funcVector(nullptr, funcMap.size());
-
-    // copy atributes
-    funcVector.userAnnotation = userAnnotation;
-    funcVector.detectedAnnotation = detectedAnnotation;
-
-    // calc averages of functionalisations
-    for (int i=0; i<MVector::nChannels; i++)
-    {
-        if (!sensorFailures[i])
-        {
-            int func = functionalisation[i];
-            int vectorIndex = funcMap.keys().indexOf(func);
-            funcVector[vectorIndex] += vector[i] / funcMap[func];
-        }
-    }
-
-    return funcVector;
+    return getFuncVector(FunctionalisationIndex::cached(functionalisation, sensorFailures), InputFunctionType::average);
 }
 
 MVector MVector::getFuncMedianAverageVector(const Functionalisation &functionalisation, const std::vector<bool> &sensorFailures, int nMedian)
@@ -278,57 +252,7 @@ MVector MVector::getFuncMedianAverageVector(const Functionalisation &functionali
     Q_ASSERT(functionalisation.size() == this->size);
     Q_ASSERT(sensorFailures.size() == this->size);
 
-    // get func map
-    auto funcMap = functionalisation.getFuncMap(sensorFailures);
-
-    // init func vector
-    RelativeMVector medianAverageVector(nullptr, funcMap.size());
-
-    // copy atributes
-    medianAverageVector.userAnnotation = userAnnotation;
-    medianAverageVector.detectedAnnotation = detectedAnnotation;
-
-    // create list of functionalisation values
-    QMap<int, QList<double>> funcValueMap;
-    for (int i=0; i<MVector::nChannels; i++)
-    {
-        if (!sensorFailures[i])
-        {
-            int func = functionalisation[i];
-            funcValueMap[func].append(vector[i]);
-        }
-    }
-
-    // calculate values of medianAverage Vector
-    for (int func : funcValueMap.keys())
-    {
-        if (funcValueMap[func].size() > nMedian)
-        {
-            // sort value list
-            std::sort(funcValueMap[func].begin(), funcValueMap[func].end());
-
-            // remove non-median values
-            // -> nMedian values remain in list
-            bool removeLast = false;
-            while(funcValueMap[func].size() > nMedian)
-            {
-                if (removeLast)
-                    funcValueMap[func].removeLast();
-                else
-                    funcValueMap[func].removeFirst();
-
-                removeLast = !removeLast;
-            }
-        }
-
-        // calculate averages of median values
-        int vectorIndex = funcMap.keys().indexOf(func);
-
-        for (int i=0; i<funcValueMap[func].size(); i++)
-            medianAverageVector[vectorIndex] += funcValueMap[func][i] / funcValueMap[func].size();
-    }
-
-    return medianAverageVector;
+    return getFuncVector(FunctionalisationIndex::cached(functionalisation, sensorFailures), InputFunctionType::medianAverage, nMedian);
 }
 
 MVector MVector::getFuncVector(const Functionalisation &functionalisation, const std::vector<bool> &sensorFailures, InputFunctionType inputFunction)
@@ -336,16 +260,34 @@ MVector MVector::getFuncVector(const Functionalisation &functionalisation, const
     Q_ASSERT(functionalisation.size() == this->size);
     Q_ASSERT(sensorFailures.size() == this->size);
 
-    switch (inputFunction) {
-    case InputFunctionType::none:
+    if (inputFunction == InputFunctionType::none)
         return *this;
-    case InputFunctionType::average:
-        return getFuncAverageVector(functionalisation, sensorFailures);
-    case InputFunctionType::medianAverage:
-        return getFuncMedianAverageVector(functionalisation, sensorFailures);
-    default:
-        throw std::invalid_argument("Unhandled InputFunctionType!");
-    }
+
+    return getFuncVector(FunctionalisationIndex::cached(functionalisation, sensorFailures), inputFunction);
+}
+
+/*!
+ * \brief MVector::getFuncVector returns the func vector of this using the precomputed channel grouping \a index.
+ * Use this overload to compute the func vectors of many vectors with the same functionalisation and sensor failures.
+ */
+MVector MVector::getFuncVector(const FunctionalisationIndex &index, InputFunctionType inputFunction, int nMedian)
+{
+    Q_ASSERT(index.getNChannels() == static_cast<int>(this->size));
+
+    if (inputFunction == InputFunctionType::none)
+        return *this;
+
+    // no funcs set:
+    // return relativevector
+    if (inputFunction == InputFunctionType::average && index.getNFuncs() == 1)
+        return *this;
+
+    MVector funcVector(nullptr, index.getNFuncs());
+    funcVector.userAnnotation = userAnnotation;
+    funcVector.detectedAnnotation = detectedAnnotation;
+    index.aggregate(vector.data(), funcVector.vector.data(), inputFunction, nMedian);
+
+    return funcVector;
 }
 
 AbsoluteMVector *MVector::getBaseVector() const
@@ -8,6 +8,7 @@
 #include "annotation.h"
 #include "classifier_definitions.h"
 #include "functionalisation.h"
+#include "functionalisationindex.h"
 
 // forward declarations
 class AbsoluteMVector;
@@ -83,6 +84,8 @@ public:
 
     MVector getFuncVector(const Functionalisation &functionalisation, const std::vector<bool> &sensorFailures, InputFunctionType inputFunction = InputFunctionType::medianAverage);
 
+    MVector getFuncVector(const FunctionalisationIndex &index, InputFunctionType inputFunction = InputFunctionType::medianAverage, int nMedian = 4);
+
     AbsoluteMVector *getBaseVector() const;
 
     MVector squared() const;
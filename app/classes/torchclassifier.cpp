@@ -1,7 +1,9 @@
 #include "torchclassifier.h"
+#include "functionalisationindex.h"
 
 #include <QtCore>
 
+#include <algorithm>
 #include <iostream>
 #include <memory>
 
@@ -63,17 +65,27 @@ TorchClassifier::TorchClassifier(QObject *parent, QString filename, bool* loadOk
 
     M = classNames.size();
 
+    // window length:
+    // models with W > 1 get the last W functionalisation vectors of each timestamp
+    if (module.hasattr("W"))
+    {
+        W = module.attr("W").toInt();
+        if (W < 1)
+        {
+            *loadOk = false;
+            *errorString += "Model is inconsistent: Window length W is " + QString::number(W) + ", but has to be at least 1!\n";
+            W = 1;
+        }
+    }
+
     // input function
     if (module.hasattr("input_function"))
     {
         QString input_function = module.attr("input_function").toString()->string().c_str();
 
-        if (input_function == "average")
-            inputFunctionType = InputFunctionType::average;
-        else if (input_function == "median_average")
-            inputFunctionType = InputFunctionType::medianAverage;
-        else if (input_function == "None")
-            inputFunctionType = InputFunctionType::none;
+        auto inputFunctionTypeMap = FunctionalisationIndex::getInputFunctionTypeMap();
+        if (inputFunctionTypeMap.contains(input_function))
+            inputFunctionType = inputFunctionTypeMap[input_function];
     }
 
     // output function
@@ -134,6 +146,18 @@ TorchClassifier::TorchClassifier(QObject *parent, QString filename, bool* loadOk
         }
     }
 
+    // fuse normalisation into one multiply-add per input:
+    // (x - mean) / stdev = x * scale + offset
+    inputScale.assign(N, 1.f);
+    inputOffset.assign(N, 0.f);
+    if (!stdev_vector.empty())
+        for (int i=0; i<N; i++)
+        {
+            double mean = mean_vector.empty() ? 0. : mean_vector[i];
+            inputScale[i] = 1. / stdev_vector[i];
+            inputOffset[i] = -mean / stdev_vector[i];
+        }
+
     if (module.hasattr("preset_name"))
         presetName = QString(module.attr("preset_name").toString()->string().c_str());
 
@@ -145,43 +169,82 @@ TorchClassifier::TorchClassifier(QObject *parent, QString filename, bool* loadOk
         *errorString += "See the classifier section <a href=\"https://github.com/Tilagiho/eNoseAnnotator/blob/master/README.md\">documentation</a> for more information.\n";
 }
 
-at::Tensor TorchClassifier::forward(std::vector<double> rawInput)
+at::Tensor TorchClassifier::forward(const at::Tensor &inputTensor)
 {
-    // create float vector
-    std::vector<float> floatVector;
-    for (double value : rawInput)
-        floatVector.push_back(static_cast<float>(value));
     // Create a vector of inputs.
-    torch::Tensor inputTensor = at::from_blob(floatVector.data(), {1, 8});
-
-//    std::cout << "Called forward with input: " << inputTensor.slice(1,0,8);
+    // windowed models take a batch x W x N tensor
     std::vector<torch::jit::IValue> inputs;
-    inputs.push_back(inputTensor);
+    inputs.push_back(W > 1 ? inputTensor.view({-1, W, N}) : inputTensor);
 
     // Execute the model and turn its output into a tensor.
-    at::Tensor output = module.forward(inputs).toTensor();
+    return module.forward(inputs).toTensor();
+}
+
+/*!
+ * \brief TorchClassifier::inputBuffer returns a \a rows x (W*N) view of the input tensor of the calling thread.
+ * The tensor is reused between calls and only reallocated if more rows are needed.
+ * It is released when the thread finishes, e.g. the thread of a classification run or an expired thread of a thread pool.
+ */
+at::Tensor TorchClassifier::inputBuffer(int64_t rows)
+{
+    QMutexLocker locker(&inputBufferMutex);
 
-//    std::cout << "Calculated output: " << output.slice(1,0,classNames.size());
+    QThread *thread = QThread::currentThread();
+    if (!inputBuffers.contains(thread))
+    {
+        // finished is emitted from the finishing thread:
+        // the entry is removed before the address of the thread can be reused
+        connect(thread, &QThread::finished, this, [this, thread]() {
+            QMutexLocker locker(&inputBufferMutex);
+            inputBuffers.remove(thread);
+        }, Qt::DirectConnection);
+    }
 
+    at::Tensor &buffer = inputBuffers[thread];
+    if (!buffer.defined() || buffer.size(0) < rows)
+        buffer = torch::empty({rows, static_cast<int64_t>(W * N)}, torch::kFloat);
 
-    return output;
+    return buffer.narrow(0, 0, rows);
 }
 
-Annotation TorchClassifier::getAnnotation(std::vector<double> input)
+/*!
+ * \brief TorchClassifier::writeInput writes the normalised \a input to \a dest (W*N floats).
+ * \a input contains W functionalisation vectors, oldest first.
+ * Throws std::invalid_argument if \a input does not have W*N elements.
+ */
+void TorchClassifier::writeInput(float *dest, const std::vector<double> &input) const
 {
-    if (input.size() != N)
+    if (input.size() != W * N)
         throw std::invalid_argument("Input vector has wrong size.");
 
-//    std::cout << "input" << input << "\n";
-    auto normalised_input = normalise(input);
-//    std::cout << "normalised input" << normalised_input << "\n";
+    const double* src = input.data();
+    for (int w=0; w<W; w++)
+        for (int j=0; j<N; j++)
+            *dest++ = static_cast<float>(*src++ * inputScale[j] + inputOffset[j]);
+}
 
-    // get class probabilities
-    auto output = forward(normalised_input);
+/*!
+ * \brief TorchClassifier::toInputTensor creates a (last-first) x (W*N) tensor of the normalised input vectors in [\a first, \a last).
+ * The normalisation is written directly into the reused input buffer.
+ */
+at::Tensor TorchClassifier::toInputTensor(const std::vector<std::vector<double>> &inputs, size_t first, size_t last)
+{
+    Q_ASSERT(first <= last && last <= inputs.size());
+
+    at::Tensor inputTensor = inputBuffer(static_cast<int64_t>(last - first));
+    float* ptr = inputTensor.data_ptr<float>();
 
-//    std::cout << "output: " << output.slice(1,0,classNames.size()) << "\n";
+    for (size_t i=first; i<last; i++, ptr+=W*N)
+        writeInput(ptr, inputs[i]);
 
-    // apply outputFunction
+    return inputTensor;
+}
+
+/*!
+ * \brief TorchClassifier::toProbabilities applies the output function of the model to \a output row-wise.
+ */
+at::Tensor TorchClassifier::toProbabilities(const at::Tensor &output) const
+{
     at::Tensor probabilities;
     if (outputFunctionType == OutputFunctionType::logsoftmax)
         probabilities = torch::softmax(output, 1);
@@ -190,15 +253,60 @@ Annotation TorchClassifier::getAnnotation(std::vector<double> input)
     else
         probabilities = output;
 
-//    std::cout << "probabilities: " << probabilities.slice(1,0,classNames.size()) << "\n";
+    return probabilities.to(torch::kFloat).contiguous();
+}
+
+Annotation TorchClassifier::getAnnotation(const std::vector<double> &input)
+{
+    torch::NoGradGuard noGrad;
+
+    at::Tensor inputTensor = inputBuffer(1);
+    writeInput(inputTensor.data_ptr<float>(), input);
 
+    at::Tensor probabilities = toProbabilities(forward(inputTensor));
+    return toAnnotation(probabilities.data_ptr<float>());
+}
+
+/*!
+ * \brief TorchClassifier::getAnnotations classifies all vectors of \a inputs.
+ * The inputs are passed to the model in batches of \a batchSize vectors, so the forward call is executed once per batch instead of once per vector.
+ * Throws std::invalid_argument if an input vector does not have W*N elements.
+ */
+QList<Annotation> TorchClassifier::getAnnotations(const std::vector<std::vector<double>> &inputs, int batchSize)
+{
+    if (batchSize <= 0)
+        throw std::invalid_argument("Batch size has to be positive.");
+
+    QList<Annotation> annotations;
+    annotations.reserve(inputs.size());
+
+    torch::NoGradGuard noGrad;
+    for (size_t first=0; first<inputs.size(); first+=batchSize)
+    {
+        size_t last = std::min(first + batchSize, inputs.size());
+
+        // get class probabilities
+        at::Tensor probabilities = toProbabilities(forward(toInputTensor(inputs, first, last)));
 
+        const float* ptr = probabilities.data_ptr<float>();
+        for (size_t i=first; i<last; i++)
+            annotations << toAnnotation(ptr + (i-first) * probabilities.size(1));
+    }
+
+    return annotations;
+}
+
+/*!
+ * \brief TorchClassifier::toAnnotation makes the prediction for one row of class \a probabilities (M values).
+ */
+Annotation TorchClassifier::toAnnotation(const float *probabilities) const
+{
     //                              //
     // extract classes from tensor  //
     //                              //
     QSet<aClass> classSet;
 
-    float* ptr = (float*) probabilities.data_ptr();
+    const float* ptr = probabilities;
     for (int i = 0; i < classNames.size(); ++i)
         classSet << aClass(classNames[i], *ptr++);
 
@@ -232,14 +340,8 @@ Annotation TorchClassifier::getAnnotation(std::vector<double> input)
     // get class with highest probabillity
     else
     {
-        for (aClass aclass : classSet)
-            if (predClasses.isEmpty())
-                predClasses << aclass;
-            else if (aclass.getValue() > predClasses.begin()->getValue())
-            {
-                predClasses.clear();
-                predClasses << aClass(aclass);
-            }
+        int maxIndex = static_cast<int>(std::max_element(probabilities, probabilities + classNames.size()) - probabilities);
+        predClasses << aClass(classNames[maxIndex], probabilities[maxIndex]);
     }
     // no regression:
     // ignore value of predicted classes
@@ -277,6 +379,14 @@ int TorchClassifier::getN() const
     return N;
 }
 
+/*!
+ * \brief TorchClassifier::getW returns the number of consecutive functionalisation vectors in each model input
+ */
+int TorchClassifier::getW() const
+{
+    return W;
+}
+
 int TorchClassifier::getM() const
 {
     return M;
@@ -292,28 +402,20 @@ InputFunctionType TorchClassifier::getInputFunctionType() const
     return inputFunctionType;
 }
 
-std::vector<double> TorchClassifier::normalise(std::vector<double> input)
+OutputFunctionType TorchClassifier::getOutputFunctionType() const
 {
-    Q_ASSERT(input.size() == N);
-
-    // variance not set:
-    // don't normalise
-    if (stdev_vector.empty())
-        return input;
-
-    // mean not set:
-    // zero init
-    if (mean_vector.empty())
-        for (int i=0; i<N; i++)
-            mean_vector.push_back(0.0);
-
-    Q_ASSERT(mean_vector.size() == N);
-    Q_ASSERT(stdev_vector.size() == N);
-
-    std::vector<double> normalised_vector;
-    for (uint i=0; i<N; i++)
-        normalised_vector.push_back((input[i] - mean_vector[i]) / stdev_vector[i]);
+    return outputFunctionType;
+}
 
-    return normalised_vector;
+bool TorchClassifier::getIsMultiLabel() const
+{
+    return isMultiLabel;
+}
 
+/*!
+ * \brief TorchClassifier::getThreshold returns the min probability of classes predicted by multi-label models
+ */
+double TorchClassifier::getThreshold() const
+{
+    return threshold;
 }
@@ -3,6 +3,7 @@
 
 #include <QObject>
 #include <QtCore>
+#include <QMutex>
 
 #undef slots
 #include <torch/script.h>
@@ -12,6 +13,8 @@
 
 #include "classifier_definitions.h"
 
+#define TORCH_CLASSIFIER_DEFAULT_BATCH_SIZE 256 // number of input vectors per forward call in getAnnotations
+
 class TorchClassifier : public QObject
 {
     Q_OBJECT
@@ -19,7 +22,9 @@ class TorchClassifier : public QObject
 public:  
     explicit TorchClassifier(QObject *parent= nullptr, QString filename = "", bool* loadOk = nullptr, QString *errorString = nullptr, int nInputs=8);
 
-    Annotation getAnnotation (std::vector<double> input);
+    Annotation getAnnotation (const std::vector<double> &input);
+
+    QList<Annotation> getAnnotations (const std::vector<std::vector<double>> &inputs, int batchSize = TORCH_CLASSIFIER_DEFAULT_BATCH_SIZE);
 
     QString getName() const;
 
@@ -33,10 +38,18 @@ public:
 
     int getM() const;
 
+    int getW() const;
+
     QString getPresetName() const;
 
     InputFunctionType getInputFunctionType() const;
 
+    OutputFunctionType getOutputFunctionType() const;
+
+    bool getIsMultiLabel() const;
+
+    double getThreshold() const;
+
 signals:
     void isInputAbsoluteSet (bool);
 
@@ -51,15 +64,23 @@ private:
     QString filename;
     QString presetName = "None";
     int N, M;
+    int W = 1;      // window length
     std::vector<double> mean_vector, stdev_vector;
+    std::vector<float> inputScale, inputOffset;     // fused normalisation
+    QHash<QThread*, at::Tensor> inputBuffers;       // reused input tensor of each running inference thread
+    QMutex inputBufferMutex;                        // guards inputBuffers
     InputFunctionType inputFunctionType = InputFunctionType::average;
     OutputFunctionType outputFunctionType = OutputFunctionType::logsoftmax;
     bool isMultiLabel = false;
     bool isRegression = false;
     double threshold = 0.3;
 
-    at::Tensor forward (std::vector<double> input);
-    std::vector<double> normalise(std::vector<double> input);
+    at::Tensor forward (const at::Tensor &inputTensor);
+    at::Tensor inputBuffer (int64_t rows);
+    void writeInput (float *dest, const std::vector<double> &input) const;
+    at::Tensor toInputTensor (const std::vector<std::vector<double>> &inputs, size_t first, size_t last);
+    at::Tensor toProbabilities (const at::Tensor &output) const;
+    Annotation toAnnotation (const float *probabilities) const;
 };
 
 #endif // TORCHCLASSIFIER_H
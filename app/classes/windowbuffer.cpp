@@ -0,0 +1,80 @@
+#include "windowbuffer.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+/*!
+ * \brief WindowBuffer::WindowBuffer creates an empty buffer of the last \a W vectors of length \a N.
+ * Throws std::invalid_argument if \a W < 1 or \a N < 0.
+ */
+WindowBuffer::WindowBuffer(int W, int N):
+    W(W),
+    N(N)
+{
+    if (W < 1)
+        throw std::invalid_argument("Window length has to be at least 1.");
+    if (N < 0)
+        throw std::invalid_argument("Vector size must not be negative.");
+
+    data.assign(static_cast<size_t>(W) * static_cast<size_t>(N), 0.);
+}
+
+/*!
+ * \brief WindowBuffer::push adds \a vector as the newest vector, replacing the oldest one if the buffer is full.
+ * Throws std::invalid_argument if \a vector does not have N elements.
+ */
+void WindowBuffer::push(const std::vector<double> &vector)
+{
+    if (static_cast<int>(vector.size()) != N)
+        throw std::invalid_argument("Input vector has wrong size.");
+
+    int index = (head + count) % W;
+    std::copy(vector.begin(), vector.end(), data.begin() + index * N);
+
+    if (count < W)
+        count++;
+    else
+        head = (head + 1) % W;
+}
+
+bool WindowBuffer::isFull() const
+{
+    return count == W;
+}
+
+int WindowBuffer::size() const
+{
+    return count;
+}
+
+/*!
+ * \brief WindowBuffer::window returns the buffered vectors oldest first.
+ * The ring is unrolled with two contiguous copies.
+ */
+std::vector<double> WindowBuffer::window() const
+{
+    std::vector<double> result;
+    result.reserve(static_cast<size_t>(count * N));
+
+    int firstPart = std::min(count, W - head);
+    result.insert(result.end(), data.begin() + head * N, data.begin() + (head + firstPart) * N);
+    result.insert(result.end(), data.begin(), data.begin() + (count - firstPart) * N);
+
+    return result;
+}
+
+void WindowBuffer::clear()
+{
+    head = 0;
+    count = 0;
+}
+
+int WindowBuffer::getW() const
+{
+    return W;
+}
+
+int WindowBuffer::getN() const
+{
+    return N;
+}
@@ -0,0 +1,38 @@
+#ifndef WINDOWBUFFER_H
+#define WINDOWBUFFER_H
+
+#include <vector>
+#include <cstddef>
+
+/*!
+ * \brief The WindowBuffer class is a ring buffer of the last W vectors of length N.
+ * Each vector is copied once when pushed, window() returns the buffered vectors oldest first as one W*N vector.
+ * Used to build the input of classifiers with a window length W > 1.
+ */
+class WindowBuffer
+{
+public:
+    WindowBuffer(int W = 1, int N = 0);
+
+    void push(const std::vector<double> &vector);
+
+    bool isFull() const;
+
+    int size() const;
+
+    std::vector<double> window() const;
+
+    void clear();
+
+    int getW() const;
+
+    int getN() const;
+
+private:
+    int W, N;
+    std::vector<double> data;   // W*N values, vector k starts at k*N
+    int head = 0;               // index of the oldest vector
+    int count = 0;
+};
+
+#endif // WINDOWBUFFER_H
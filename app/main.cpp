@@ -4,20 +4,23 @@
 #include <QtCore>
 
 #include "classes/controler.h"
+#include "widgets/plotcanvas.h"
 //#include "classes/curvefitworker.h"
 
 #define CLI_CURVE_FIT_OPTION "--curve-fit"
 
 int main(int argc, char *argv[])
 {
-    QApplication a(argc, argv);
-    a.setApplicationName("eNoseAnnotator");
-
     // init application settings
     QCoreApplication::setOrganizationName("smart nanotubes GmbH");
 //    QCoreApplication::setOrganizationDomain("mysoft.com");
     QCoreApplication::setApplicationName("eNoseAnnotator");
 
+    // the OpenGL implementation has to be selected before the application is created
+    PlotCanvas::initApplication();
+
+    QApplication a(argc, argv);
+
     // setup breakpad crash handler:
     // save crash minidumps in reports
     QString gitCommit(GIT_VERSION);
@@ -35,7 +38,7 @@ int main(int argc, char *argv[])
     QTimer::singleShot(0, &c, &Controler::initialize);
 
     // start application
-    if (!c.getParseResult().curveFit)
+    if (!c.getParseResult().curveFit && c.getParseResult().exportDir.isEmpty())
         c.getWindow()->show();
     return a.exec();
 }
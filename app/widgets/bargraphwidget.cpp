@@ -3,12 +3,13 @@
 #include "../classes/enosecolor.h"
 #include "../classes/defaultSettings.h"
 #include "fixedplotmagnifier.h"
+#include "plotcanvas.h"
+#include "renderscheduler.h"
 
 #include <qwt_column_symbol.h>
 #include <qwt_scale_draw.h>
 #include <qwt_scale_engine.h>
 #include <qwt_plot_grid.h>
-#include <qwt_plot_renderer.h>
 #include <qwt_interval_symbol.h>
 #include <qwt_symbol.h>
 #include <qwt_painter.h>
@@ -128,6 +129,18 @@ void ErrorBarMarker::setFailure(bool value)
     failure = value;
 }
 
+/*!
+ * \brief ErrorBarMarker::getLines returns the vertical line and both horizontal lines of the error bar in plot coordinates
+ */
+QVector<QLineF> ErrorBarMarker::getLines() const
+{
+    return QVector<QLineF>{
+        QLineF(index, value - error, index, value + error),
+        QLineF(index - width, value - error, index + width, value - error),
+        QLineF(index - width, value + error, index + width, value + error)
+    };
+}
+
 QRectF ErrorBarMarker::boundingRect() const
 {
     QPointF topLeft (index - width, value + error);
@@ -171,15 +184,19 @@ QwtColumnSymbol* BarChartItem::specialSymbol(
     symbol->setLineWidth( 2 );
     symbol->setFrameStyle( QwtColumnSymbol::FrameStyle::Raised );
 
-    QColor c( Qt::white );
-    if ( index >= 0 && index < d_colors.size() )
-        c = d_colors[ index ];
-
-    symbol->setPalette( c );
+    symbol->setPalette( getColor( index ) );
 
     return symbol;
 }
 
+QColor BarChartItem::getColor(int index) const
+{
+    if ( index >= 0 && index < d_colors.size() )
+        return d_colors[ index ];
+
+    return QColor( Qt::white );
+}
+
 QwtText BarChartItem::barTitle( int sampleIndex ) const
 {
     QwtText title;
@@ -191,9 +208,13 @@ QwtText BarChartItem::barTitle( int sampleIndex ) const
 
 AbstractBarGraphWidget::AbstractBarGraphWidget( QWidget *parent ) :
     QwtPlot(parent),
-    d_barChartItem (new BarChartItem),
-    rectangleZoom(new FixedPlotZoomer(QwtPlot::xBottom, QwtPlot::yLeft, canvas()))
+    d_barChartItem (new BarChartItem)
 {
+    // the zoomer is a child of the canvas:
+    // create it after the canvas was set
+    PlotCanvas::create(this);
+    rectangleZoom = new FixedPlotZoomer(QwtPlot::xBottom, QwtPlot::yLeft, canvas());
+
     setCanvasBackground(QBrush(GRAPH_BACKGROUND_COLOR));
 
     setAxisTitle( QwtPlot::yLeft, QString(u8"\u0394") + "R / R0 [%]" );
@@ -230,6 +251,15 @@ AbstractBarGraphWidget::AbstractBarGraphWidget( QWidget *parent ) :
     rectangleZoom->setMousePattern( QwtEventPattern::MouseSelect3,Qt::MiddleButton, Qt::ShiftModifier); //zoom out by 1
 }
 
+/*!
+ * \brief AbstractBarGraphWidget::replot updates the axes and requests a replot from the RenderScheduler
+ */
+void AbstractBarGraphWidget::replot()
+{
+    updateAxes();
+    RenderScheduler::instance().requestReplot(this);
+}
+
 QRectF AbstractBarGraphWidget::boundingRect() const
 {
     auto b_rect = d_barChartItem->boundingRect();
@@ -314,17 +344,46 @@ void AbstractBarGraphWidget::clear()
     replot();
 }
 
-void AbstractBarGraphWidget::exportGraph(QString filePath)
+/*!
+ * \brief AbstractBarGraphWidget::getSnapshot returns the visible part of the graph for GraphExporter.
+ * The snapshot has \a size in pixels, if \a size is invalid it is the size of the graph at GRAPH_EXPORT_DPI.
+ */
+GraphSnapshot AbstractBarGraphWidget::getSnapshot(QSize size) const
 {
-    int widthResolution = logicalDpiX();  //width dots per inch
-    int heightResolution = logicalDpiY();  //width dots per inch
+    GraphSnapshot snapshot;
+    snapshot.scale = static_cast<double>(GRAPH_EXPORT_DPI) / logicalDpiX();
+    snapshot.size = size.isValid() ? size : this->size() * snapshot.scale;
+    snapshot.background = canvasBackground().color();
+    snapshot.xAxis = GraphSnapshot::getAxis(this, QwtPlot::xBottom);
+    snapshot.yAxis = GraphSnapshot::getAxis(this, QwtPlot::yLeft);
+
+    // bars:
+    // width of the bars in the graph, the spacing between bars is in pixels
+    double pixelsPerBar = canvas()->width() / std::max(1., snapshot.xAxis.interval.width());
+    double barWidth = qBound(0.1, 1. - d_barChartItem->spacing() / std::max(1., pixelsPerBar), 1.);
+    for (size_t i=0; i<d_barChartItem->data()->size(); i++)
+    {
+        QPointF sample = d_barChartItem->data()->sample(i);
+        snapshot.rects << GraphSnapshot::Rect{QRectF(QPointF(sample.x() - barWidth / 2, 0.), QPointF(sample.x() + barWidth / 2, sample.y())), d_barChartItem->getColor(static_cast<int>(i))};
+    }
+
+    // error bars
+    if (errorBarsVisible && !errorBars.isEmpty())
+    {
+        GraphSnapshot::Lines lines;
+        lines.pen = errorBars.first()->linePen();
+        for (auto errorBar : errorBars)
+            if (!errorBar->getFailure())
+                lines.lines << errorBar->getLines();
+        snapshot.lines << lines;
+    }
 
-    double widthMM = 25.4 * static_cast<double>(size().width()) / static_cast<double>(widthResolution);
-    double heightMM = 25.4 * static_cast<double>(size().height()) / static_cast<double>(heightResolution);
-    QSizeF sizeMM(widthMM, heightMM);
+    return snapshot;
+}
 
-    QwtPlotRenderer renderer;
-    renderer.renderDocument(this, filePath, sizeMM, 150);
+bool AbstractBarGraphWidget::getDataSelected() const
+{
+    return dataSelected;
 }
 
 void AbstractBarGraphWidget::setErrorBarsVisible(bool value)
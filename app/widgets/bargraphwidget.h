@@ -5,6 +5,7 @@
 
 #include "../classes/mvector.h"
 #include "fixedplotzoomer.h"
+#include "graphexporter.h"
 
 #include <qwt_plot.h>
 #include <qwt_plot_barchart.h>
@@ -23,6 +24,8 @@ public:
 
     bool getFailure() const;
 
+    QVector<QLineF> getLines() const;
+
 protected:
     void draw(QPainter *pPainter,const QwtScaleMap &pXMap, const QwtScaleMap &pYMap, const QRectF &pBoundingRectangle) const override;
 
@@ -46,6 +49,8 @@ public:
 
     virtual QwtText barTitle( int sampleIndex ) const override;
 
+    QColor getColor( int index ) const;
+
 private:
     QList<QColor> d_colors;
     QList<QString> d_labels;
@@ -60,6 +65,12 @@ public:
 
     void setAutoScale(bool value);
 
+    virtual void replot() override;
+
+    GraphSnapshot getSnapshot(QSize size = QSize()) const;
+
+    bool getDataSelected() const;
+
 signals:
     void imageSaveRequested();
     void selectionVectorSaveRequested();
@@ -68,7 +79,6 @@ signals:
 public slots:
     void setVector(const MVector &vector, const MVector &stdDevVector, const std::vector<bool> sensorFailures, const Functionalisation &functionalisation);
     void clear();
-    void exportGraph(QString filePath);
     void setErrorBarsVisible(bool);
     void setZoomBase();
     void setAxisIntv (QwtInterval intv, QwtPlot::Axis axis);
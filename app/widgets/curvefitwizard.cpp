@@ -38,6 +38,8 @@ CurveFitWizard::CurveFitWizard(MeasurementData* mData, QWidget* parent):
 
     connect(introPage, &IntroPage::nIterationsChanged, worker, &CurveFitWorker::setNIterations);
     connect(introPage, &IntroPage::limitFactorChanged, worker, &CurveFitWorker::setLimitFactor);
+    connect(introPage, &IntroPage::batchedChanged, worker, &CurveFitWorker::setBatched);
+    connect(introPage, &IntroPage::useCacheChanged, worker, &CurveFitWorker::setUseCache);
 
     // range determination
     connect(worker, &CurveFitWorker::rangeRedeterminationPossible, introPage, &IntroPage::setRangeRedeterminationPossible);
@@ -75,9 +77,9 @@ CurveFitWizard::~CurveFitWizard()
     worker->deleteLater();
 }
 
-void CurveFitWizard::selectType()
+void CurveFitWizard::selectType(QString typeString)
 {
-    auto type = LeastSquaresFitter::getTypeMap()[field("typeSelector").toString()];
+    auto type = LeastSquaresFitter::getTypeMap()[typeString];
     worker->setType(type);
 }
 
@@ -114,7 +116,7 @@ void CurveFitWizard::fitCurves()
 
     qDebug() << "\n--------\nStarting curve fit:";
     qDebug() << "max thread count:\t" << QString::number(QThreadPool::globalInstance()->maxThreadCount());
-    for (size_t i=0; i<nChannels; i++)
+    for (int i=0; i<worker->getNRuns(); i++)
         QThreadPool::globalInstance()->start(worker);
 }
 
@@ -124,6 +126,8 @@ IntroPage::IntroPage(QWidget* parent):
     typeSelector(new QComboBox),
     detectExpositionStartCheckBox(new QCheckBox),
     detectRecoveryCheckBox(new QCheckBox),
+    batchedCheckBox(new QCheckBox),
+    useCacheCheckBox(new QCheckBox),
     limitFactorSpinBox(new QDoubleSpinBox),
     jumpFactorSpinBox(new QDoubleSpinBox),
     jumpBaseThresholdSpinBox(new QDoubleSpinBox),
@@ -136,9 +140,14 @@ IntroPage::IntroPage(QWidget* parent):
 
     auto modelTypeMap = LeastSquaresFitter::getTypeMap();
 
-    // add to comboBox
+    // add to comboBox:
+    // function of the model as tooltip
     for (QString modelString : modelTypeMap.keys())
+    {
+        std::unique_ptr<LeastSquaresFitter> fitter(LeastSquaresFitter::create(modelTypeMap[modelString]));
         typeSelector->addItem(modelString);
+        typeSelector->setItemData(typeSelector->count()-1, fitter->getFunctionString(), Qt::ToolTipRole);
+    }
     LeastSquaresFitter::Type defaultType = CVWIZ_DEFAULT_MODEL_TYPE;
     int index = modelTypeMap.values().indexOf(defaultType);
     typeSelector->setCurrentText(modelTypeMap.keys()[index]);
@@ -158,6 +167,14 @@ IntroPage::IntroPage(QWidget* parent):
     modelLayout->addRow("Conversion limit factor", limitFactorSpinBox);
     modelLayout->labelForField(limitFactorSpinBox)->setToolTip("The convergion limit defines the maximum convergion value of accepted solutions.\nConvergion limit = convergion limit factor * maxValue(channel)");
 
+    batchedCheckBox->setCheckState(CVWIZ_DEFAULT_BATCHED ? Qt::CheckState::Checked : Qt::CheckState::Unchecked);
+    modelLayout->addRow("Batched fit", batchedCheckBox);
+    modelLayout->labelForField(batchedCheckBox)->setToolTip("Fit " + QString::number(BATCHED_FIT_DEFAULT_BATCH_SIZE) + " channels at once with the Levenberg-Marquardt algorithm.\nFaster, but only one algorithm is used for each channel.");
+
+    useCacheCheckBox->setCheckState(CVWIZ_DEFAULT_USE_CACHE ? Qt::CheckState::Checked : Qt::CheckState::Unchecked);
+    modelLayout->addRow("Use cached results", useCacheCheckBox);
+    modelLayout->labelForField(useCacheCheckBox)->setToolTip("Restore the results of channels whose data range and settings did not change since a previous fit.");
+
     modelGroupBox->setLayout(modelLayout);
 
     QGroupBox *detectiongroupBox = new QGroupBox(tr("Detection settings"));
@@ -205,6 +222,8 @@ IntroPage::IntroPage(QWidget* parent):
     connect(typeSelector, &QComboBox::currentTextChanged, this, &IntroPage::typeChanged);
     connect(nIterationsSpinBox, SIGNAL(valueChanged(int)), this, SIGNAL(nIterationsChanged(int)));
     connect(limitFactorSpinBox, SIGNAL(valueChanged(double)), this, SIGNAL(limitFactorChanged(double)));
+    connect(batchedCheckBox, &QCheckBox::clicked, this, &IntroPage::batchedChanged);
+    connect(useCacheCheckBox, &QCheckBox::clicked, this, &IntroPage::useCacheChanged);
 
     connect(jumpBaseThresholdSpinBox, SIGNAL(valueChanged(double)), this, SIGNAL(jumpBaseThresholdChanged(double)));
     connect(jumpFactorSpinBox, SIGNAL(valueChanged(double)), this, SIGNAL(jumpFactorChanged(double)));
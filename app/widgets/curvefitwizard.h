@@ -29,6 +29,8 @@ Q_SIGNALS:
     void typeChanged(QString typeString);
     void nIterationsChanged(const int &value);
     void limitFactorChanged(const double &value);
+    void batchedChanged(bool batched);
+    void useCacheChanged(bool useCache);
     void jumpBaseThresholdChanged(double jumpBaseThreshold);
     void jumpFactorChanged(double jumpFactor);
     void recoveryFactorChanged (double recoveryFactor);
@@ -45,7 +47,7 @@ public Q_SLOTS:
 private:
     QFormLayout *detectionLayout;
     QComboBox *typeSelector;
-    QCheckBox *detectExpositionStartCheckBox, *detectRecoveryCheckBox;
+    QCheckBox *detectExpositionStartCheckBox, *detectRecoveryCheckBox, *batchedCheckBox, *useCacheCheckBox;
     QDoubleSpinBox *limitFactorSpinBox, *jumpFactorSpinBox, *jumpBaseThresholdSpinBox, *recoveryFactorSpinBox;
     QSpinBox *nIterationsSpinBox, *fitBufferSpinBox, *recoveryTimeSpinBox;
     bool rangeRedeterminationPossible = false;
@@ -127,7 +129,7 @@ public:
     ~CurveFitWizard();
 
 public Q_SLOTS:
-    void selectType();
+    void selectType(QString typeString);
     void saveData();
     void updateChannelRange();
     void fitCurves();
@@ -2,6 +2,8 @@
 #include "ui_generalsettings.h"
 
 #include "../classes/defaultSettings.h"
+#include "../classes/functionalisationindex.h"
+#include "plotcanvas.h"
 
 #include <QFileDialog>
 
@@ -12,6 +14,14 @@ GeneralSettingsDialog::GeneralSettingsDialog(QWidget *parent) :
     ui->setupUi(this);
     this->setWindowTitle("Settings");
 
+    // func graphs need one value per func:
+    // keeping the channel values is not selectable
+    auto inputFunctionTypeMap = FunctionalisationIndex::getInputFunctionTypeMap();
+    for (auto it = inputFunctionTypeMap.constBegin(); it != inputFunctionTypeMap.constEnd(); it++)
+        if (it.value() != InputFunctionType::none)
+            ui->inputFunctionComboBox->addItem(it.key());
+
+    ui->plotCanvasComboBox->addItems(PlotCanvas::getTypeMap().keys());
 }
 
 GeneralSettingsDialog::~GeneralSettingsDialog()
@@ -81,6 +91,36 @@ void GeneralSettingsDialog::setPresetDir(QString presetDirPath)
     ui->presetDirlineEdit->setText(presetDir.absolutePath());
 }
 
+QString GeneralSettingsDialog::getInputFunction() const
+{
+    return ui->inputFunctionComboBox->currentText();
+}
+
+void GeneralSettingsDialog::setInputFunction(QString inputFunction)
+{
+    ui->inputFunctionComboBox->setCurrentText(inputFunction);
+}
+
+QString GeneralSettingsDialog::getPlotCanvas() const
+{
+    return ui->plotCanvasComboBox->currentText();
+}
+
+void GeneralSettingsDialog::setPlotCanvas(QString plotCanvas)
+{
+    ui->plotCanvasComboBox->setCurrentText(plotCanvas);
+}
+
+int GeneralSettingsDialog::getMaxFps() const
+{
+    return ui->maxFpsSpinBox->value();
+}
+
+void GeneralSettingsDialog::setMaxFps(int maxFps)
+{
+    ui->maxFpsSpinBox->setValue(maxFps);
+}
+
 void GeneralSettingsDialog::on_presetDirPushButton_clicked()
 {
     QString presetDir = QFileDialog::getExistingDirectory(this, "Set preset folder", ui->presetDirlineEdit->text());
@@ -94,4 +134,7 @@ void GeneralSettingsDialog::on_defaultPushButton_clicked()
     ui->maxValSpinBox->setValue(DEFAULT_UPPER_LIMIT);
     ui->useLimitsCheckBox->setCheckState(DEFAULT_USE_LIMITS ? Qt::CheckState::Checked : Qt::CheckState::Unchecked);
     ui->presetDirlineEdit->setText(QDir(DEFAULT_PRESET_DIR).absolutePath());
+    ui->inputFunctionComboBox->setCurrentText(DEFAULT_FUNC_INPUT_FUNCTION);
+    ui->plotCanvasComboBox->setCurrentText(DEFAULT_PLOT_CANVAS);
+    ui->maxFpsSpinBox->setValue(DEFAULT_RENDER_MAX_FPS);
 }
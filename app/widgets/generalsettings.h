@@ -31,6 +31,15 @@ public:
     QString getPresetDir() const;
     void setPresetDir(QString presetDir);
 
+    QString getInputFunction() const;
+    void setInputFunction(QString inputFunction);
+
+    QString getPlotCanvas() const;
+    void setPlotCanvas(QString plotCanvas);
+
+    int getMaxFps() const;
+    void setMaxFps(int maxFps);
+
 private slots:
     void on_buttonBox_accepted();
 
@@ -0,0 +1,364 @@
+#include "graphexporter.h"
+
+#include "../classes/defaultSettings.h"
+
+#include <QImage>
+#include <QPainter>
+#include <QPdfWriter>
+#include <QSvgGenerator>
+#include <QtConcurrent>
+
+#include <qwt_plot.h>
+#include <qwt_scale_div.h>
+#include <qwt_scale_draw.h>
+#include <qwt_scale_map.h>
+#include <qwt_text.h>
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <stdexcept>
+
+namespace {
+
+/*!
+ * \brief rotatedSize returns the size of the bounding rect of \a size rotated by \a rotation degrees
+ */
+QSizeF rotatedSize(const QSizeF &size, double rotation)
+{
+    double angle = qDegreesToRadians(rotation);
+    double c = std::abs(std::cos(angle));
+    double s = std::abs(std::sin(angle));
+
+    return QSizeF(c * size.width() + s * size.height(), s * size.width() + c * size.height());
+}
+
+/*!
+ * \brief scaledPen returns \a pen with cosmetic widths replaced by one graph widget pixel,
+ * so lines are scaled with the exported image like in the graph widget
+ */
+QPen scaledPen(QPen pen)
+{
+    if (qFuzzyIsNull(pen.widthF()))
+        pen.setWidthF(1.);
+    pen.setCosmetic(false);
+
+    return pen;
+}
+
+}
+
+/*!
+ * \brief GraphSnapshot::getAxis returns the visible interval, title and labeled major ticks of axis \a axisId of \a plot
+ */
+GraphSnapshot::Axis GraphSnapshot::getAxis(const QwtPlot *plot, int axisId)
+{
+    Axis axis;
+    axis.interval = plot->axisInterval(axisId).normalized();
+    axis.title = plot->axisTitle(axisId).text();
+
+    const QwtScaleDraw *scaleDraw = plot->axisScaleDraw(axisId);
+    axis.labelRotation = scaleDraw->labelRotation();
+    for (double value : plot->axisScaleDiv(axisId).ticks(QwtScaleDiv::MajorTick))
+        if (axis.interval.contains(value))
+            axis.ticks << qMakePair(value, scaleDraw->label(value).text());
+
+    return axis;
+}
+
+GraphExporter::GraphExporter(QObject *parent):
+    QObject(parent)
+{
+}
+
+GraphExporter::~GraphExporter()
+{
+    pool.waitForDone();
+}
+
+/*!
+ * \brief GraphExporter::exportGraph renders \a snapshot to \a filePath in the thread pool and returns immediately.
+ * Emits graphExported or exportFailed from the rendering thread when done.
+ */
+void GraphExporter::exportGraph(const GraphSnapshot &snapshot, QString filePath)
+{
+    QtConcurrent::run(&pool, [this, snapshot, filePath]() {
+        try {
+            render(snapshot, filePath);
+            emit graphExported(filePath);
+        } catch (std::exception &e) {
+            {
+                QMutexLocker locker(&failuresMutex);
+                failures << qMakePair(filePath, QString(e.what()));
+            }
+            emit exportFailed(filePath, e.what());
+        }
+    });
+}
+
+/*!
+ * \brief GraphExporter::waitForDone blocks until all exports were rendered.
+ * Returns the file paths and error strings of the exports failed since the last call.
+ */
+QList<QPair<QString, QString>> GraphExporter::waitForDone()
+{
+    pool.waitForDone();
+
+    QMutexLocker locker(&failuresMutex);
+    QList<QPair<QString, QString>> failedExports;
+    failedExports.swap(failures);
+    return failedExports;
+}
+
+/*!
+ * \brief GraphExporter::render renders \a snapshot to \a filePath. The format is determined by the suffix of \a filePath:
+ * svg and pdf files are vector graphics, all other suffixes are saved as raster images with the size of \a snapshot.
+ * Does not access any widget, so it can be called from any thread.
+ * Throws std::runtime_error if the file cannot be written.
+ */
+void GraphExporter::render(const GraphSnapshot &snapshot, QString filePath)
+{
+    if (snapshot.size.isEmpty())
+        throw std::runtime_error("Cannot export " + filePath.toStdString() + ": Graph has no size.");
+
+    QString suffix = QFileInfo(filePath).suffix().toLower();
+    QPainter painter;
+
+    if (suffix == "svg")
+    {
+        QSvgGenerator generator;
+        generator.setFileName(filePath);
+        generator.setSize(snapshot.size);
+        generator.setViewBox(QRect(QPoint(0, 0), snapshot.size));
+        generator.setResolution(GRAPH_EXPORT_DPI);
+
+        if (!painter.begin(&generator))
+            throw std::runtime_error("Cannot write " + filePath.toStdString() + ".");
+        paint(&painter, snapshot);
+        painter.end();
+    }
+    else if (suffix == "pdf")
+    {
+        QPdfWriter writer(filePath);
+        writer.setResolution(GRAPH_EXPORT_DPI);
+        writer.setPageSize(QPageSize(QSizeF(snapshot.size) * 25.4 / GRAPH_EXPORT_DPI, QPageSize::Millimeter));
+        writer.setPageMargins(QMarginsF(0., 0., 0., 0.));
+
+        if (!painter.begin(&writer))
+            throw std::runtime_error("Cannot write " + filePath.toStdString() + ".");
+        paint(&painter, snapshot);
+        painter.end();
+    }
+    else
+    {
+        QImage image(snapshot.size, QImage::Format_ARGB32);
+        int dotsPerMeter = qRound(GRAPH_EXPORT_DPI / 0.0254);
+        image.setDotsPerMeterX(dotsPerMeter);
+        image.setDotsPerMeterY(dotsPerMeter);
+        image.fill(Qt::white);
+
+        painter.begin(&image);
+        paint(&painter, snapshot);
+        painter.end();
+
+        if (!image.save(filePath))
+            throw std::runtime_error("Cannot write " + filePath.toStdString() + ".");
+    }
+}
+
+/*!
+ * \brief GraphExporter::paint draws \a snapshot with \a painter.
+ * The layout is computed in graph widget pixels, which are scaled to the exported image by snapshot.scale.
+ */
+void GraphExporter::paint(QPainter *painter, const GraphSnapshot &snapshot)
+{
+    painter->setRenderHint(QPainter::Antialiasing, true);
+    painter->setRenderHint(QPainter::TextAntialiasing, true);
+    painter->scale(snapshot.scale, snapshot.scale);
+
+    QRectF rect(0., 0., snapshot.size.width() / snapshot.scale, snapshot.size.height() / snapshot.scale);
+    painter->fillRect(rect, Qt::white);
+
+    QFont font;
+    font.setPixelSize(GE_FONT_SIZE);
+    QFont titleFont = font;
+    titleFont.setPixelSize(GE_TITLE_FONT_SIZE);
+    titleFont.setBold(true);
+    QFontMetricsF fm(font), titleFm(titleFont);
+
+    auto textSize = [](const QFontMetricsF &metrics, const QString &text) {
+        return metrics.boundingRect(QRectF(), Qt::AlignCenter, text).size();
+    };
+
+    // layout:
+    // space for the tick labels and titles left of and below the canvas
+    const auto &xAxis = snapshot.xAxis;
+    const auto &yAxis = snapshot.yAxis;
+
+    QSizeF xLabelSize(0., 0.), yLabelSize(0., 0.);
+    for (const auto &tick : xAxis.ticks)
+        xLabelSize = xLabelSize.expandedTo(rotatedSize(textSize(fm, tick.second), xAxis.labelRotation));
+    for (const auto &tick : yAxis.ticks)
+        yLabelSize = yLabelSize.expandedTo(rotatedSize(textSize(fm, tick.second), yAxis.labelRotation));
+
+    double xTitleHeight = xAxis.title.isEmpty() ? 0. : textSize(titleFm, xAxis.title).height() + GE_SPACING;
+    double yTitleHeight = yAxis.title.isEmpty() ? 0. : textSize(titleFm, yAxis.title).height() + GE_SPACING;
+
+    double left = GE_MARGIN + yTitleHeight + yLabelSize.width() + GE_SPACING + GE_TICK_LENGTH;
+    double bottom = GE_MARGIN + xTitleHeight + xLabelSize.height() + GE_SPACING + GE_TICK_LENGTH;
+    double top = GE_MARGIN + fm.height() / 2;
+    double right = GE_MARGIN + (qFuzzyIsNull(xAxis.labelRotation) ? xLabelSize.width() / 2 : 0.);
+
+    QRectF canvas = rect.adjusted(left, top, -right, -bottom);
+    if (!canvas.isValid())
+        throw std::runtime_error("Export size is too small.");
+
+    QwtScaleMap xMap, yMap;
+    xMap.setPaintInterval(canvas.left(), canvas.right());
+    xMap.setScaleInterval(xAxis.interval.minValue(), xAxis.interval.maxValue());
+    yMap.setPaintInterval(canvas.bottom(), canvas.top());
+    yMap.setScaleInterval(yAxis.interval.minValue(), yAxis.interval.maxValue());
+
+    auto transform = [&xMap, &yMap](const QPointF &point) {
+        return QPointF(xMap.transform(point.x()), yMap.transform(point.y()));
+    };
+
+    // canvas
+    painter->fillRect(canvas, snapshot.background);
+    painter->save();
+    painter->setClipRect(canvas);
+
+    // grid
+    painter->setPen(QPen(Qt::black, 0., Qt::DotLine));
+    for (const auto &tick : xAxis.ticks)
+    {
+        double x = xMap.transform(tick.first);
+        painter->drawLine(QLineF(x, canvas.top(), x, canvas.bottom()));
+    }
+    for (const auto &tick : yAxis.ticks)
+    {
+        double y = yMap.transform(tick.first);
+        painter->drawLine(QLineF(canvas.left(), y, canvas.right(), y));
+    }
+
+    for (const auto &rectItem : snapshot.rects)
+        painter->fillRect(QRectF(transform(rectItem.rect.topLeft()), transform(rectItem.rect.bottomRight())).normalized(), rectItem.color);
+
+    for (const auto &linesItem : snapshot.lines)
+    {
+        painter->setPen(scaledPen(linesItem.pen));
+        for (const auto &line : linesItem.lines)
+            painter->drawLine(QLineF(transform(line.p1()), transform(line.p2())));
+    }
+
+    for (const auto &series : snapshot.series)
+    {
+        QPolygonF polygon;
+        polygon.reserve(series.samples.size());
+        for (const auto &sample : series.samples)
+            polygon << transform(sample);
+
+        painter->setPen(scaledPen(series.pen));
+        painter->setBrush(Qt::NoBrush);
+        painter->drawPolyline(polygon);
+
+        if (series.symbolSize > 0.)
+        {
+            double radius = series.symbolSize / 2;
+            painter->setPen(Qt::NoPen);
+            painter->setBrush(series.pen.color());
+            for (const auto &point : polygon)
+                painter->drawEllipse(point, radius, radius);
+        }
+    }
+
+    painter->restore();
+
+    // canvas frame & ticks
+    painter->setPen(scaledPen(QPen(Qt::black)));
+    painter->setBrush(Qt::NoBrush);
+    painter->drawRect(canvas);
+
+    painter->setFont(font);
+    for (const auto &tick : xAxis.ticks)
+    {
+        double x = xMap.transform(tick.first);
+        painter->drawLine(QLineF(x, canvas.bottom(), x, canvas.bottom() + GE_TICK_LENGTH));
+
+        QSizeF size = textSize(fm, tick.second);
+        painter->save();
+        painter->translate(x, canvas.bottom() + GE_TICK_LENGTH + GE_SPACING);
+        if (qFuzzyIsNull(xAxis.labelRotation))
+        {
+            painter->drawText(QRectF(-size.width() / 2, 0., size.width(), size.height()), Qt::AlignCenter, tick.second);
+        }
+        else
+        {
+            // rotated labels end at the tick
+            painter->rotate(xAxis.labelRotation);
+            painter->drawText(QRectF(-size.width(), 0., size.width(), size.height()), Qt::AlignRight | Qt::AlignTop, tick.second);
+        }
+        painter->restore();
+    }
+
+    for (const auto &tick : yAxis.ticks)
+    {
+        double y = yMap.transform(tick.first);
+        painter->drawLine(QLineF(canvas.left() - GE_TICK_LENGTH, y, canvas.left(), y));
+
+        QSizeF size = textSize(fm, tick.second);
+        QRectF labelRect(canvas.left() - GE_TICK_LENGTH - GE_SPACING - size.width(), y - size.height() / 2, size.width(), size.height());
+        painter->drawText(labelRect, Qt::AlignRight | Qt::AlignVCenter, tick.second);
+    }
+
+    // axis titles
+    painter->setFont(titleFont);
+    if (!xAxis.title.isEmpty())
+        painter->drawText(QRectF(canvas.left(), rect.bottom() - GE_MARGIN - xTitleHeight, canvas.width(), xTitleHeight), Qt::AlignCenter, xAxis.title);
+    if (!yAxis.title.isEmpty())
+    {
+        painter->save();
+        painter->translate(GE_MARGIN, canvas.bottom());
+        painter->rotate(-90.);
+        painter->drawText(QRectF(0., 0., canvas.height(), yTitleHeight), Qt::AlignCenter, yAxis.title);
+        painter->restore();
+    }
+
+    // legend:
+    // top right corner of the canvas, as many columns as needed
+    if (!snapshot.legend.isEmpty())
+    {
+        painter->setFont(font);
+        double entryHeight = fm.height();
+        double iconWidth = 2 * entryHeight;
+        double textWidth = 0.;
+        for (const auto &entry : snapshot.legend)
+            textWidth = std::max(textWidth, textSize(fm, entry.first).width());
+
+        double columnWidth = iconWidth + textWidth + 2 * GE_SPACING;
+        int nRows = std::max(1, static_cast<int>((canvas.height() - 2 * GE_MARGIN - 2 * GE_SPACING) / entryHeight));
+        nRows = std::min(nRows, snapshot.legend.size());
+        int nColumns = (snapshot.legend.size() + nRows - 1) / nRows;
+
+        QRectF legendRect(0., 0., nColumns * columnWidth + GE_SPACING, nRows * entryHeight + 2 * GE_SPACING);
+        legendRect.moveTopRight(QPointF(canvas.right() - GE_MARGIN, canvas.top() + GE_MARGIN));
+
+        QColor legendBackground = snapshot.background;
+        legendBackground.setAlpha(200);
+        painter->setPen(scaledPen(QPen(Qt::black)));
+        painter->setBrush(legendBackground);
+        painter->drawRect(legendRect);
+
+        for (int i=0; i<snapshot.legend.size(); i++)
+        {
+            double x = legendRect.left() + GE_SPACING + (i / nRows) * columnWidth;
+            double y = legendRect.top() + GE_SPACING + (i % nRows) * entryHeight;
+
+            painter->setPen(scaledPen(QPen(snapshot.legend[i].second)));
+            painter->drawLine(QLineF(x, y + entryHeight / 2, x + iconWidth, y + entryHeight / 2));
+
+            painter->setPen(Qt::black);
+            painter->drawText(QRectF(x + iconWidth + GE_SPACING, y, textWidth, entryHeight), Qt::AlignLeft | Qt::AlignVCenter, snapshot.legend[i].first);
+        }
+    }
+}
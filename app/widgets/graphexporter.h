@@ -0,0 +1,100 @@
+#ifndef GRAPHEXPORTER_H
+#define GRAPHEXPORTER_H
+
+#include <QObject>
+#include <QtCore>
+#include <QColor>
+#include <QPen>
+
+#include <qwt_interval.h>
+
+#define GE_FONT_SIZE 12         // pixel size of tick labels and legend entries in graph widget pixels
+#define GE_TITLE_FONT_SIZE 13   // pixel size of axis titles
+#define GE_MARGIN 10
+#define GE_SPACING 4
+#define GE_TICK_LENGTH 6
+
+class QPainter;
+class QwtPlot;
+
+/*!
+ * \brief The GraphSnapshot class holds everything needed to render a graph without accessing its widget:
+ * the axes with their tick labels, the curves decimated to the export resolution, filled rectangles (bars, annotations, selection) and the legend.
+ * All coordinates are plot coordinates, except size.
+ */
+class GraphSnapshot
+{
+public:
+    struct Axis
+    {
+        QwtInterval interval;
+        QString title;
+        QList<QPair<double, QString>> ticks;    // major ticks and their labels
+        double labelRotation = 0.;              // in degrees
+    };
+
+    struct Series
+    {
+        QPen pen;
+        QVector<QPointF> samples;
+        double symbolSize = 0.;                 // diameter of the sample symbols, 0: no symbols
+    };
+
+    struct Lines
+    {
+        QPen pen;
+        QVector<QLineF> lines;
+    };
+
+    struct Rect
+    {
+        QRectF rect;
+        QColor color;
+    };
+
+    QSize size;                                 // in pixels of the exported image
+    double scale = 1.;                          // pixels of the exported image per pixel of the graph widget
+    QColor background = Qt::white;              // of the canvas
+
+    Axis xAxis, yAxis;
+    QList<Rect> rects;                          // drawn first
+    QList<Lines> lines;
+    QList<Series> series;                       // drawn last
+    QList<QPair<QString, QColor>> legend;
+
+    static Axis getAxis(const QwtPlot *plot, int axisId);
+};
+
+/*!
+ * \brief The GraphExporter class renders GraphSnapshots to image (png, jpg, bmp), svg or pdf files in a thread pool.
+ * Several graphs are exported in parallel. The result of each export is signalled by graphExported or exportFailed,
+ * failed exports are also returned by waitForDone.
+ */
+class GraphExporter : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit GraphExporter(QObject *parent = nullptr);
+    ~GraphExporter();
+
+    void exportGraph(const GraphSnapshot &snapshot, QString filePath);
+
+    QList<QPair<QString, QString>> waitForDone();
+
+    static void render(const GraphSnapshot &snapshot, QString filePath);
+
+signals:
+    void graphExported(QString filePath);
+    void exportFailed(QString filePath, QString errorString);
+
+private:
+    QThreadPool pool;       // renders the snapshots
+
+    QMutex failuresMutex;
+    QList<QPair<QString, QString>> failures;    // file path and error string of failed exports since the last waitForDone
+
+    static void paint(QPainter *painter, const GraphSnapshot &snapshot);
+};
+
+#endif // GRAPHEXPORTER_H
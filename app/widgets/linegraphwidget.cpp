@@ -3,10 +3,15 @@
 #include "../classes/defaultSettings.h"
 #include "../classes/measurementdata.h"
 #include "../classes/enosecolor.h"
+#include "../classes/functionalisationindex.h"
 #include "../classes/defaultSettings.h"
 #include "fixedplotmagnifier.h"
+#include "plotcanvas.h"
+#include "renderscheduler.h"
 
 #include <float.h>
+#include <algorithm>
+#include <cmath>
 
 #include <qwt_plot.h>
 #include <qwt_plot_canvas.h>
@@ -21,55 +26,368 @@
 #include <qwt_date_scale_engine.h>
 
 #include <qwt_plot_marker.h>
-#include <qwt_plot_renderer.h>
 
 #include <QMouseEvent>
 #include <QMenu>
 #include <QGuiApplication>
+#include <QtConcurrent>
 
 /*!
  * \brief The CurveData class is a container for the data of one curve. It enables appending data to the curve.
  * Based on qwt example "realtime".
+ *
+ * The curve only stores its y values. The x values are the time coordinates of the samples, which are shared by
+ * all curves of the line graphs (see TimeAxis): sample i is (times[i], values[i]).
+ * Selection curves store no values at all, they serve a range of the samples of their data curve.
+ *
+ * Long curves are served with a level of detail:
+ * a min/max pyramid of the samples is built while appending. Level k splits the samples into blocks of LGW_LOD_FACTOR^(k+1) samples
+ * and stores the samples with the min and max y value of each block. Qwt only gets the samples within the rect of interest,
+ * at most two per block of the coarsest level with no more blocks than the resolution (canvas width in pixels).
+ * Peaks stay visible, because the served points are the extreme samples of each block.
+ * The samples have to be appended in ascending order of x.
  */
-CurveData::CurveData()
+CurveData::CurveData(const QVector<double> *times):
+    times(times)
 {
+    Q_ASSERT(times != nullptr);
     clear();    // init d_bounding_rect
 }
 
+/*!
+ * \brief CurveData::CurveData creates a curve serving the samples [first, last) of \a source set by setRange.
+ * The range is empty until setRange is called.
+ */
+CurveData::CurveData(const CurveData *source):
+    times(source->times),
+    source(source)
+{
+    clear();
+}
+
 QRectF CurveData::boundingRect() const
 {
     if ( d_boundingRect.width() < 0.0 )
-        d_boundingRect = qwtBoundingRect( *this );
+        d_boundingRect = samplesBoundingRect();
 
     return d_boundingRect.normalized();
 }
 
-inline void CurveData::append( const QPointF &point )
+size_t CurveData::size() const
+{
+    updateView();
+    return viewBlocks ? view.size() : static_cast<size_t>(viewSize);
+}
+
+QPointF CurveData::sample(size_t i) const
+{
+    return point(viewBlocks ? view[i] : viewFirst + static_cast<int>(i));
+}
+
+/*!
+ * \brief CurveData::servesRange returns true if the served samples are a contiguous range of the samples.
+ * Then the last served samples are the last samples, if these are within the rect of interest.
+ */
+bool CurveData::servesRange() const
+{
+    updateView();
+    return !viewBlocks;
+}
+
+/*!
+ * \brief CurveData::setRectOfInterest is called by qwt with the visible area whenever the axes are updated,
+ * e.g. by replots after zooming, panning or magnifying. Only samples in the x range of \a rect are served.
+ */
+void CurveData::setRectOfInterest(const QRectF &rect)
+{
+    rectOfInterest = rect.normalized();
+    viewValid = false;
+}
+
+/*!
+ * \brief CurveData::append adds the sample (times[n], \a value), where n is the number of samples.
+ * The time coordinate has to be added to the shared times before.
+ */
+inline void CurveData::append( double value )
 {
-    d_samples += point;
+    Q_ASSERT(source == nullptr);
+    Q_ASSERT(times->size() > values.size());
 
-    // resize bounding rectangle, if necessary, to contain point:
-    // init bounding rectangle
-    if ( qFuzzyCompare(d_boundingRect.width(), 0.0) && qFuzzyCompare(d_boundingRect.height(), 0.0) )
-        d_boundingRect = qwtBoundingRect( *this );
+    values << value;
+    rangeLast = values.size();
+    addToLevels(rangeLast - 1);
+    viewValid = false;
 
-    if (!d_boundingRect.contains(point))
+    // resize bounding rectangle, if necessary, to contain point
+    QPointF newPoint = point(rangeLast - 1);
+    if (rangeLast == 1)
+    {
+        d_boundingRect = QRectF(newPoint, QSizeF(0., 0.));
+    }
+    else if (d_boundingRect.width() >= 0.0)
     {
-        d_boundingRect = d_boundingRect | QRectF(d_boundingRect.center(), point);
-        d_boundingRect = d_boundingRect.normalized();
+        QPointF topLeft(std::min(d_boundingRect.left(), newPoint.x()), std::min(d_boundingRect.top(), newPoint.y()));
+        QPointF bottomRight(std::max(d_boundingRect.right(), newPoint.x()), std::max(d_boundingRect.bottom(), newPoint.y()));
+        d_boundingRect = QRectF(topLeft, bottomRight);
     }
 }
 
+/*!
+ * \brief CurveData::clear removes all samples of data curves. Curves serving a range of another curve serve an empty range.
+ */
 void CurveData::clear()
 {
-    d_samples.clear();
-    d_samples.squeeze();
-    d_boundingRect = QRectF( 0.0, 0.0, 0.0, 0.0 );
+    values.clear();
+    values.squeeze();
+    levels.clear();
+    rangeFirst = 0;
+    rangeLast = 0;
+    d_boundingRect = QRectF( 0.0, 0.0, -1.0, -1.0 );
+
+    view.clear();
+    viewValid = false;
+}
+
+/*!
+ * \brief CurveData::setValues swaps the y values of the curve with \a values and updates the bounding rectangle.
+ * The shared times have to contain at least as many time coordinates.
+ */
+void CurveData::setValues(QVector<double> &newValues)
+{
+    Q_ASSERT(source == nullptr);
+    Q_ASSERT(times->size() >= newValues.size());
+
+    values.swap(newValues);
+    rangeFirst = 0;
+    rangeLast = values.size();
+    d_boundingRect = QRectF( 0.0, 0.0, -1.0, -1.0 );
+
+    levels.clear();
+    for (int i=0; i<values.size(); i++)
+        addToLevels(i);
+    viewValid = false;
+}
+
+/*!
+ * \brief CurveData::setRange sets the samples [\a first, \a last) of the source curve served by this curve
+ */
+void CurveData::setRange(int first, int last)
+{
+    Q_ASSERT(source != nullptr);
+
+    rangeFirst = std::max(0, first);
+    rangeLast = std::min(std::max(rangeFirst, last), source->getLast());
+    d_boundingRect = QRectF( 0.0, 0.0, -1.0, -1.0 );
+    viewValid = false;
+}
+
+/*!
+ * \brief CurveData::setResolution sets the max number of blocks served for the rect of interest, usually the canvas width in pixels
+ */
+void CurveData::setResolution(int value)
+{
+    resolution = std::max(1, value);
+    viewValid = false;
+}
+
+/*!
+ * \brief CurveData::getFirst returns the index of the first sample of the curve in the shared times
+ */
+int CurveData::getFirst() const
+{
+    return rangeFirst;
+}
+
+/*!
+ * \brief CurveData::getLast returns the index after the last sample of the curve in the shared times
+ */
+int CurveData::getLast() const
+{
+    return rangeLast;
+}
+
+/*!
+ * \brief CurveData::point returns the sample at \a index of the shared times, getFirst() <= index < getLast()
+ */
+QPointF CurveData::point(int index) const
+{
+    return QPointF((*times)[index], getValues()[index]);
+}
+
+const QVector<double> &CurveData::getValues() const
+{
+    return source != nullptr ? source->values : values;
+}
+
+const std::vector<std::vector<CurveData::Block>> &CurveData::getLevels() const
+{
+    return source != nullptr ? source->levels : levels;
+}
+
+/*!
+ * \brief CurveData::addToLevels adds sample \a index to the blocks of all levels.
+ * A level is created once the samples exceed one block of the previous level, its first block is initialised with the previous samples.
+ */
+void CurveData::addToLevels(int index)
+{
+    int nSamples = index + 1;
+    long blockSize = LGW_LOD_FACTOR;
+    for (size_t k=0; blockSize / LGW_LOD_FACTOR < nSamples; k++, blockSize *= LGW_LOD_FACTOR)
+    {
+        if (k == levels.size())
+        {
+            levels.push_back(std::vector<Block>{ {0, 0} });
+            for (int j=1; j<index; j++)
+                updateBlock(levels[k][0], j);
+        }
+
+        auto &level = levels[k];
+        size_t block = static_cast<size_t>(index / blockSize);
+        if (block == level.size())
+            level.push_back({index, index});
+        else
+            updateBlock(level[block], index);
+    }
+}
+
+void CurveData::updateBlock(Block &block, int index) const
+{
+    double y = values[index];
+    if (y < values[block.minIndex])
+        block.minIndex = index;
+    if (y > values[block.maxIndex])
+        block.maxIndex = index;
+}
+
+/*!
+ * \brief CurveData::updateView selects the samples served for the rect of interest
+ */
+void CurveData::updateView() const
+{
+    if (viewValid)
+        return;
+    viewValid = true;
+
+    viewBlocks = selectSamples(rectOfInterest, resolution, &viewFirst, &viewSize, &view);
+}
+
+/*!
+ * \brief CurveData::selectSamples selects the samples in the x range of \a rect with at most \a maxBlocks blocks.
+ * The x range is found by binary search in the samples, which are sorted by x.
+ * It includes one sample left and right of the rect, so lines leaving the visible area are drawn.
+ * Returns false if the range [\a first, \a first + \a size) is selected.
+ * Ranges of more than two samples per block are selected as the extreme samples of the level of detail blocks:
+ * returns true and sets \a indices to the indices of the extreme samples.
+ * Block extremes outside the samples of a curve serving a range of another curve are skipped.
+ */
+bool CurveData::selectSamples(const QRectF &rect, int maxBlocks, int *first, int *size, std::vector<int> *indices) const
+{
+    indices->clear();
+
+    // sample range of the rect
+    int firstIndex = rangeFirst;
+    int last = rangeLast;
+    if (!rect.isNull() && rect.width() > 0.)
+    {
+        auto range = getIndexRange(rect.left(), rect.right());
+        firstIndex = std::max(rangeFirst, range.first - 1);
+        last = std::min(rangeLast, range.second + 1);
+    }
+    int count = std::max(0, last - firstIndex);
+
+    // few samples in range:
+    // select the range
+    *first = firstIndex;
+    *size = count;
+    const auto &lodLevels = getLevels();
+    if (count <= 2 * maxBlocks || lodLevels.empty())
+        return false;
+
+    // finest level with at most maxBlocks blocks in range
+    size_t k = 0;
+    long blockSize = LGW_LOD_FACTOR;
+    while (k + 1 < lodLevels.size() && (count + blockSize - 1) / blockSize > maxBlocks)
+    {
+        k++;
+        blockSize *= LGW_LOD_FACTOR;
+    }
+
+    const auto &level = lodLevels[k];
+    size_t firstBlock = static_cast<size_t>(firstIndex / blockSize);
+    size_t lastBlock = std::min(level.size() - 1, static_cast<size_t>((last - 1) / blockSize));
+    indices->reserve(2 * (lastBlock - firstBlock + 1));
+    for (size_t block=firstBlock; block<=lastBlock; block++)
+    {
+        // extreme samples in order of x
+        int left = std::min(level[block].minIndex, level[block].maxIndex);
+        int right = std::max(level[block].minIndex, level[block].maxIndex);
+        if (left >= rangeFirst && left < rangeLast)
+            indices->push_back(left);
+        if (right != left && right >= rangeFirst && right < rangeLast)
+            indices->push_back(right);
+    }
+
+    return true;
+}
+
+/*!
+ * \brief CurveData::getDecimatedSamples returns the samples in the x range of \a rect with at most \a maxBlocks blocks,
+ * independent of the rect of interest and resolution of the curve. Used to export the curve in another resolution.
+ */
+QVector<QPointF> CurveData::getDecimatedSamples(const QRectF &rect, int maxBlocks) const
+{
+    int first, count;
+    std::vector<int> indices;
+    bool blocks = selectSamples(rect.normalized(), std::max(1, maxBlocks), &first, &count, &indices);
+
+    QVector<QPointF> samples;
+    if (!blocks)
+    {
+        samples.reserve(count);
+        for (int index=first; index<first+count; index++)
+            samples << point(index);
+        return samples;
+    }
+
+    samples.reserve(static_cast<int>(indices.size()));
+    for (int index : indices)
+        samples << point(index);
+    return samples;
+}
+
+QRectF CurveData::samplesBoundingRect() const
+{
+    if (rangeFirst >= rangeLast)
+        return QRectF( 0.0, 0.0, -1.0, -1.0 );
+
+    // x values are sorted
+    const QVector<double> &y = getValues();
+    double minY = y[rangeFirst];
+    double maxY = minY;
+    for (int i=rangeFirst+1; i<rangeLast; i++)
+    {
+        minY = std::min(minY, y[i]);
+        maxY = std::max(maxY, y[i]);
+    }
+
+    double minX = (*times)[rangeFirst];
+    double maxX = (*times)[rangeLast - 1];
+    return QRectF(minX, minY, maxX - minX, maxY - minY);
 }
 
-QVector<QPointF>* CurveData::samples()
+/*!
+ * \brief CurveData::getIndexRange returns the range [first, second) of the samples with \a minX <= x <= \a maxX.
+ * The range is found by binary search in the shared times, which are sorted.
+ */
+QPair<int, int> CurveData::getIndexRange(double minX, double maxX) const
 {
-    return &d_samples;
+    auto begin = times->constBegin() + rangeFirst;
+    auto end = times->constBegin() + rangeLast;
+
+    auto first = std::lower_bound(begin, end, minX);
+    auto last = std::upper_bound(first, end, maxX);
+
+    return QPair<int, int>(static_cast<int>(first - times->constBegin()), static_cast<int>(last - times->constBegin()));
 }
 
 QwtText ToolTipPlotPicker::trackerTextF ( const QPointF & pos ) const
@@ -81,23 +399,20 @@ QwtText ToolTipPlotPicker::trackerTextF ( const QPointF & pos ) const
 
     auto plt = plot();
 
-    // check annotation rects
-    if (text.isEmpty())
+    // check annotations
+    for (auto item : plt->itemList(LGW_ANNOTATION_ITEM_RTTI))
     {
-        QList<QwtPlotItem*> rectList = plt->itemList(1001); // AClassRectItem
+        auto annotationItem = static_cast<AnnotationItem*>(item);
 
-        for (auto item : rectList)
+        Annotation annotation;
+        if (annotationItem->getAnnotationAt(pos, &annotation))
         {
-            auto rect = static_cast<AClassRectItem*>(item);
-            if ( rect->boundingRect().contains(pos) )
-            {
-                QString annotationText;
-                annotationText += rect->getIsUserAnnotation() ? "User annotation:\n" : "Detected annotation:\n";
-                annotationText += rect->getAnnotation().toString().split(",").join("\n");
-                text.setText(annotationText);
-                text.setRenderFlags(Qt::AlignLeft);
-                break;
-            }
+            QString annotationText;
+            annotationText += annotationItem->getIsUserAnnotation() ? "User annotation:\n" : "Detected annotation:\n";
+            annotationText += annotation.toString().split(",").join("\n");
+            text.setText(annotationText);
+            text.setRenderFlags(Qt::AlignLeft);
+            break;
         }
     }
 
@@ -106,47 +421,40 @@ QwtText ToolTipPlotPicker::trackerTextF ( const QPointF & pos ) const
     {
         QList<QwtPlotItem*> curveList = plt->itemList(QwtPlotItem::Rtti_PlotCurve);
 
+        // samples closer than threshold are at most LGW_TOOLTIP_MAX_DT ms left or right of pos:
+        // only check those samples of each curve
+        auto t_pos = transform(pos);
+        auto dummyPoint = pos;
+        dummyPoint.setX(dummyPoint.x() + LGW_TOOLTIP_MAX_DT);
+        double threshold = QLineF(t_pos, transform(dummyPoint)).length();
+
         double minDistance = qInf();
-        int closestItemIndex = -1;
-        int closestPointIndex;
-        int point_index;
+        QwtPlotItem *closestItem = nullptr;
 
-        for (int i=0; i<curveList.size(); i++)
+        for (auto item : curveList)
         {
-            auto item = curveList[i];
-            double distance = qInf();
-
-            if (item->isVisible())
-            {
-                auto curve = dynamic_cast<QwtPlotCurve*>(item);
-                auto t_pos = transform(pos);
-                point_index = curve->closestPoint(t_pos, &distance);
-
-                QPointF curvePoint;
-                if (curve->data()->size() > 0)
-                    curvePoint = curve->sample(0);
+            if (!item->isVisible())
+                continue;
 
-                if (point_index < 0)
-                    continue;
+            auto curve = static_cast<QwtPlotCurve*>(item);
+            auto curveData = static_cast<CurveData*>(curve->data());
 
+            auto range = curveData->getIndexRange(pos.x() - LGW_TOOLTIP_MAX_DT, pos.x() + LGW_TOOLTIP_MAX_DT);
+            for (int i=range.first; i<range.second; i++)
+            {
+                double distance = QLineF(t_pos, transform(curveData->point(i))).length();
                 if (distance < minDistance)
                 {
                     minDistance = distance;
-                    closestItemIndex = i;
-                    closestPointIndex = point_index;
+                    closestItem = item;
                 }
             }
         }
 
         // check if pos is close to curve
-        auto dummyPoint = pos;
-        dummyPoint.setX(dummyPoint.x() + 6000);
-        double threshold = QLineF(transform(pos), transform(dummyPoint)).length();
-
-        if(minDistance > threshold) { return QwtText(); }
+        if(closestItem == nullptr || minDistance > threshold) { return QwtText(); }
 
         // if close: return curve name
-        auto closestItem = curveList[closestItemIndex];
         text = closestItem->title();
     }
 
@@ -174,60 +482,128 @@ public:
 };
 
 /*!
- * \brief AClassRectItem::AClassRectItem draws a rectangular item for displaying aclass.
- * The position of the rectangle is determined by the interval set (x) and by the position of aClass in annotation (y).
- * When drawing all aClasses of an annotation with an AClassRectItem the top margin of the graph is split into 7 parts.
+ * \brief AnnotationItem::AnnotationItem draws the user defined (\a isUserAnnotation) or detected annotations of a graph.
+ * The annotation of a timestamp is drawn from LGW_ANNOTATION_HALF_WIDTH s before to LGW_ANNOTATION_HALF_WIDTH s after the timestamp.
+ * Timestamps with equal annotations, whose rectangles touch or overlap, are merged into runs, which are drawn as one rectangle per class.
+ * The y range of each class is determined by the position of the class in the annotation.
+ * The top margin of the graph is split into 7 parts.
  * Detected annotations are drawn into the 2nd and 3rd part, user annotations into the 5th and 6th.
- *
- * \param interval
- * \param annotation
- * \param aclass
- * \param isUserAnnotation
  */
-AClassRectItem::AClassRectItem(QwtInterval xInterval, Annotation annotation, aClass aclass, bool isUserAnnotation):
-    xInterval(xInterval),
-    annotation(annotation),
-    aclass(aclass),
+AnnotationItem::AnnotationItem(bool isUserAnnotation):
     isUserAnnotation(isUserAnnotation)
 {
-    Q_ASSERT(annotation.contains(aclass));
     setZ( 10 );
 }
 
-void AClassRectItem::setInterval( QwtInterval& xValue)
+/*!
+ * \brief AnnotationItem::setAnnotation sets the annotation of \a timestamp. Empty annotations remove the annotation of \a timestamp.
+ * Only the runs next to \a timestamp are updated.
+ */
+void AnnotationItem::setAnnotation(uint timestamp, const Annotation &annotation)
 {
-    xInterval = xValue;
+    if (setDrawnAnnotation(timestamp, annotation))
+        updateRuns(timestamp, timestamp);
 }
 
-double AClassRectItem::left()
+/*!
+ * \brief AnnotationItem::setAnnotations sets the annotations of all timestamps of \a annotations.
+ * The runs are updated once for the range of changed timestamps.
+ */
+void AnnotationItem::setAnnotations(const QMap<uint, Annotation> &annotations)
 {
-    return xInterval.minValue();
+    bool changed = false;
+    uint first = 0, last = 0;
+    for (auto it = annotations.constBegin(); it != annotations.constEnd(); it++)
+    {
+        if (setDrawnAnnotation(it.key(), it.value()))
+        {
+            if (!changed)
+                first = it.key();
+            last = it.key();
+            changed = true;
+        }
+    }
+
+    if (changed)
+        updateRuns(first, last);
 }
 
-void AClassRectItem::setLeft(const double &value)
+void AnnotationItem::clear()
 {
-    xInterval.setMinValue(value);
+    annotations.clear();
+    runs.clear();
 }
 
-double AClassRectItem::right()
+/*!
+ * \brief AnnotationItem::setDrawnAnnotation stores the drawn annotation of \a timestamp:
+ * numeric classes with values <= LGW_DET_CLASS_TRESH are not drawn.
+ * Returns true if the drawn annotation changed.
+ */
+bool AnnotationItem::setDrawnAnnotation(uint timestamp, const Annotation &annotation)
 {
-    return xInterval.maxValue();
+    QList<aClass> classList;
+    for (const aClass &aclass : annotation.getClasses())
+        if (aclass.getType() != aClass::Type::NUMERIC || aclass.getValue() > LGW_DET_CLASS_TRESH)
+            classList << aclass;
+
+    if (classList.isEmpty())
+        return annotations.remove(timestamp) > 0;
+
+    Annotation drawAnnotation(classList.toSet());
+    auto it = annotations.find(timestamp);
+    if (it != annotations.end() && it.value() == drawAnnotation)
+        return false;
+
+    annotations[timestamp] = drawAnnotation;
+    return true;
 }
 
-void AClassRectItem::setRight(const double &value)
+/*!
+ * \brief AnnotationItem::updateRuns rebuilds the runs after the annotations of the timestamps in [\a first, \a last] changed.
+ * The runs containing the changed timestamps and one run on each side are rebuilt, because they might be merged with or split from the changed runs.
+ */
+void AnnotationItem::updateRuns(uint first, uint last)
 {
-    xInterval.setMaxValue(value);
+    // extend range:
+    // run containing or left of first and the run before it
+    auto it = runs.upperBound(first);
+    for (int i=0; i<2 && it != runs.begin(); i++)
+    {
+        it--;
+        first = it.key();
+    }
+
+    // run containing or right of last
+    it = runs.upperBound(last);
+    if (it != runs.begin() && std::prev(it).value().last > last)
+        last = std::prev(it).value().last;
+    if (it != runs.end())
+        last = it.value().last;
+
+    // remove runs in range
+    it = runs.lowerBound(first);
+    while (it != runs.end() && it.key() <= last)
+        it = runs.erase(it);
+
+    // rebuild runs in range:
+    // neighbouring rectangles touch if the timestamps are at most 2 * LGW_ANNOTATION_HALF_WIDTH apart
+    auto runIt = runs.end();
+    for (auto annotationIt = annotations.lowerBound(first); annotationIt != annotations.end() && annotationIt.key() <= last; annotationIt++)
+    {
+        uint timestamp = annotationIt.key();
+        if (runIt != runs.end() && timestamp - runIt.value().last <= 2u * LGW_ANNOTATION_HALF_WIDTH && runIt.value().annotation == annotationIt.value())
+            runIt.value().last = timestamp;
+        else
+            runIt = runs.insert(timestamp, Run{timestamp, annotationIt.value()});
+    }
 }
 
-void AClassRectItem::draw(QPainter *painter, const QwtScaleMap &xMap, const QwtScaleMap &yMap, const QRectF &canvasRect) const
+/*!
+ * \brief AnnotationItem::getYInterval returns the y range of the annotations in plot coordinates
+ */
+QwtInterval AnnotationItem::getYInterval() const
 {
-    double x1 = xInterval.minValue();
-    int px1 = qRound( xMap.transform( x1 ) );
-    double x2 = xInterval.maxValue();
-    int px2 = qRound( xMap.transform( x2 ) );
-
-    // determine y range of class rect
-    auto plt = static_cast<LineGraphWidget*>(plot());
+    auto plt = static_cast<const LineGraphWidget*>(plot());
 
     auto plot_b_rect = plt->boundingRect();
     auto yInterval = QwtInterval( plot_b_rect.top(), plot_b_rect.bottom() );
@@ -239,8 +615,17 @@ void AClassRectItem::draw(QPainter *painter, const QwtScaleMap &xMap, const QwtS
     double annotationTop = windowTop - (7 + yOffset) / 14. * windowHeight * LGW_Y_RELATIVE_MARGIN;
     double annotationBottom = windowTop - (10 + yOffset) / 14. * windowHeight * LGW_Y_RELATIVE_MARGIN;
 
-    double y1 = -1., y2 = -1;
-    int py1 = -1, py2 = -1;
+    return QwtInterval(annotationBottom, annotationTop);
+}
+
+/*!
+ * \brief AnnotationItem::getClassInterval sets \a y1 and \a y2 to the y range of \a aclass within \a yInterval
+ */
+void AnnotationItem::getClassInterval(const Annotation &annotation, const aClass &aclass, const QwtInterval &yInterval, double *y1, double *y2) const
+{
+    double annotationTop = yInterval.maxValue();
+    double annotationBottom = yInterval.minValue();
+
     auto classList = annotation.getClasses();
     // sum up values
     double valueSum = 0.;
@@ -257,52 +642,124 @@ void AClassRectItem::draw(QPainter *painter, const QwtScaleMap &xMap, const QwtS
 
         if (annoClass == aclass)
         {
-            y1 = annotationTop + cumulatedSum / valueSum * (annotationBottom - annotationTop);
-            py1 = qRound( yMap.transform( y1 ) );
-            y2 = annotationTop + (cumulatedSum + value) / valueSum * (annotationBottom - annotationTop);
-            py2 = qRound( yMap.transform( y2 ) );
-            break;
+            *y1 = annotationTop + cumulatedSum / valueSum * (annotationBottom - annotationTop);
+            *y2 = annotationTop + (cumulatedSum + value) / valueSum * (annotationBottom - annotationTop);
+            return;
         }
         cumulatedSum += value;
     }
-    b_rect = QRectF(x1, y1, x2-x1, y2-y1);
-    painter->fillRect( QRect(px1, py1, px2 - px1, py2 - py1), QBrush(getColor()));
 }
 
-QRectF AClassRectItem::boundingRect()
+/*!
+ * \brief AnnotationItem::draw draws the runs intersecting the visible x range
+ */
+void AnnotationItem::draw(QPainter *painter, const QwtScaleMap &xMap, const QwtScaleMap &yMap, const QRectF &canvasRect) const
 {
-    return b_rect;
+    for (const auto &rect : getRects(xMap.s1(), xMap.s2()))
+    {
+        int px1 = qRound( xMap.transform( rect.rect.left() ) );
+        int px2 = qRound( xMap.transform( rect.rect.right() ) );
+        int py1 = qRound( yMap.transform( rect.rect.top() ) );
+        int py2 = qRound( yMap.transform( rect.rect.bottom() ) );
+
+        painter->fillRect( QRect(px1, py1, px2 - px1, py2 - py1), QBrush(rect.color));
+    }
 }
 
-int AClassRectItem::rtti() const
+/*!
+ * \brief AnnotationItem::getRects returns one rectangle in plot coordinates for each class of the runs between \a minT and \a maxT
+ */
+QList<GraphSnapshot::Rect> AnnotationItem::getRects(double minT, double maxT) const
 {
-    return 1001;
+    QList<GraphSnapshot::Rect> rects;
+    if (runs.isEmpty())
+        return rects;
+
+    // timestamps in range
+    if (minT > maxT)
+        std::swap(minT, maxT);
+    uint minTimestamp = static_cast<uint>(std::max(0., std::floor(minT / 1000.) - LGW_ANNOTATION_HALF_WIDTH));
+    uint maxTimestamp = static_cast<uint>(std::max(0., std::ceil(maxT / 1000.) + LGW_ANNOTATION_HALF_WIDTH));
+
+    // first run intersecting the range
+    auto it = runs.upperBound(minTimestamp);
+    if (it != runs.begin() && std::prev(it).value().last >= minTimestamp)
+        it--;
+
+    QwtInterval yInterval = getYInterval();
+    for (; it != runs.end() && it.key() <= maxTimestamp; it++)
+    {
+        // x values in ms, see LineGraphWidget::getT
+        double x1 = 1000. * (static_cast<double>(it.key()) - LGW_ANNOTATION_HALF_WIDTH);
+        double x2 = 1000. * (static_cast<double>(it.value().last) + LGW_ANNOTATION_HALF_WIDTH);
+
+        const Annotation &annotation = it.value().annotation;
+        for (const aClass &aclass : annotation.getClasses())
+        {
+            double y1 = -1., y2 = -1.;
+            getClassInterval(annotation, aclass, yInterval, &y1, &y2);
+
+            rects << GraphSnapshot::Rect{QRectF(QPointF(x1, y1), QPointF(x2, y2)), aClass::getColor(aclass)};
+        }
+    }
+
+    return rects;
 }
 
-Annotation AClassRectItem::getAnnotation() const
+bool AnnotationItem::getAnnotationAt(const QPointF &pos, Annotation *annotation) const
 {
-    return annotation;
+    if (!getYInterval().contains(pos.y()))
+        return false;
+
+    double t = pos.x() / 1000.;
+    auto it = runs.upperBound(static_cast<uint>(std::max(0., std::floor(t) + LGW_ANNOTATION_HALF_WIDTH)));
+    for (int i=0; i<2 && it != runs.begin(); i++)
+    {
+        it--;
+        if (static_cast<double>(it.key()) - LGW_ANNOTATION_HALF_WIDTH <= t && t <= static_cast<double>(it.value().last) + LGW_ANNOTATION_HALF_WIDTH)
+        {
+            *annotation = it.value().annotation;
+            return true;
+        }
+    }
+
+    return false;
 }
 
-bool AClassRectItem::getIsUserAnnotation() const
+int AnnotationItem::rtti() const
 {
-    return isUserAnnotation;
+    return LGW_ANNOTATION_ITEM_RTTI;
 }
 
-QColor AClassRectItem::getColor() const
+bool AnnotationItem::getIsUserAnnotation() const
 {
-    return aClass::getColor(aclass);
+    return isUserAnnotation;
 }
 
 LineGraphWidget::LineGraphWidget(QWidget *parent) :
     QwtPlot(parent),
-    rectangleZoom(new FixedPlotZoomer(QwtPlot::xBottom, QwtPlot::yLeft, canvas())),
-    zonePicker(new QwtPlotPicker(canvas())),
+    userAnnotationItem(new AnnotationItem(true)),
+    detectedAnnotationItem(new AnnotationItem(false)),
     zoneItem(new QwtPlotZoneItem()),
-    toolTipPicker(new ToolTipPlotPicker(canvas())),
     coordinateLabel(new QwtPlotTextLabel),
-    legend(new QwtPlotLegendItem)
+    legend(new QwtPlotLegendItem),
+    timeAxis(new TimeAxis(this))
 {
+    // the pickers are children of the canvas:
+    // create them after the canvas was set
+    PlotCanvas::create(this);
+    rectangleZoom = new FixedPlotZoomer(QwtPlot::xBottom, QwtPlot::yLeft, canvas());
+    zonePicker = new QwtPlotPicker(canvas());
+    toolTipPicker = new ToolTipPlotPicker(canvas());
+
+    // direct painter: draws samples added during measurements without replotting
+    directPainter = new QwtPlotDirectPainter(this);
+    directPainter->setAttribute(QwtPlotDirectPainter::CopyBackingStore, true);
+
+    replotTimer.setSingleShot(true);
+    replotTimer.setInterval(LGW_REPLOT_INTERVAL);
+    connect(&replotTimer, &QTimer::timeout, this, &LineGraphWidget::replot);
+
     setCanvasBackground(QBrush(GRAPH_BACKGROUND_COLOR));
 
     QwtPlotGrid *grid = new QwtPlotGrid();
@@ -364,6 +821,10 @@ LineGraphWidget::LineGraphWidget(QWidget *parent) :
     zoneItem->setVisible(false);
     zoneItem->attach(this);
 
+    // annotations
+    userAnnotationItem->attach(this);
+    detectedAnnotationItem->attach(this);
+
     // tooltip: show curve name
     toolTipPicker->setTrackerMode(QwtPicker::AlwaysOn);
     setMouseTracking(true);
@@ -373,9 +834,10 @@ LineGraphWidget::LineGraphWidget(QWidget *parent) :
     coordinateLabel->setText( QwtText() );
     coordinateLabel->attach( this );
 
-    // axis synchronisation
+    // axis synchronisation:
+    // report changes of the x axis to the shared time axis
     QObject::connect((QwtScaleWidget*) axisWidget(QwtPlot::xBottom) , &QwtScaleWidget::scaleDivChanged, this, [this](){
-        emit axisIntvSet(axisInterval(QwtPlot::xBottom), QwtPlot::xBottom);
+        timeAxis->setInterval(axisInterval(QwtPlot::xBottom));
     });
 
     // functionalisation legend
@@ -400,19 +862,16 @@ void LineGraphWidget::clearGraph()
         delete selectionCurves[i];
     }
 
-    for (auto label : userDefinedClassLabels)
-        for (auto rect : label)
-            delete rect;
-
-    for (auto label : detectedClassLabels)
-        for (auto rect : label)
-            delete rect;
-
     dataCurves.clear();
     selectionCurves.clear();
-    userDefinedClassLabels.clear();
-    detectedClassLabels.clear();
+    userAnnotationItem->clear();
+    detectedAnnotationItem->clear();
     legend->clearLegend();
+    legendEntries.clear();
+
+    // time coordinates of shared time axes are cleared by their owner
+    if (timeAxis->parent() == this)
+        timeAxis->clear();
 
     if (replotStatus)
         replot();
@@ -489,10 +948,9 @@ void LineGraphWidget::setFunctionalisation(const Functionalisation &functionalis
 
 void LineGraphWidget::setAnnotations(const QMap<uint, Annotation> &annotations, bool isUserAnnotation)
 {
-    for (uint timestamp : annotations.keys())
-        setLabel(timestamp, annotations[timestamp], isUserAnnotation);
+    AnnotationItem *annotationItem = isUserAnnotation ? userAnnotationItem : detectedAnnotationItem;
+    annotationItem->setAnnotations(annotations);
 
-    adjustLabels(isUserAnnotation);
     if (replotStatus)
         replot();
 }
@@ -638,39 +1096,29 @@ bool LineGraphWidget::selectPoints(double min, double max)
     if (dataCurves.isEmpty())
         return false;
 
-    // find selected points
-    auto data = static_cast<CurveData*>(dataCurves[0]->data())->samples()->toStdVector();
+    // find selected points:
+    // the shared time coordinates are sorted
+    const QVector<double> &times = timeAxis->getTimes();
+    auto dataEnd = times.begin() + static_cast<CurveData*>(dataCurves[0]->data())->getLast();
 
-    auto startElement = std::find_if(data.begin(), data.end(), [min](QPointF p){
-        return p.rx() > min;
-    });
-    if (startElement == data.end()) // selection starts right of curve
+    auto startElement = std::upper_bound(times.begin(), dataEnd, min);
+    if (startElement == dataEnd) // selection starts right of curve
         return false;
 
-    auto endElement = std::find_if(startElement, data.end(), [max](QPointF p){
-        return p.rx() > max;
-    });
-    if (endElement == data.begin()) // selection ends left of curve
+    auto endElement = std::upper_bound(startElement, dataEnd, max);
+    if (endElement == times.begin()) // selection ends left of curve
         return false;
 
-    int startIndex = std::distance(data.begin(), startElement);
-    int endIndex = std::distance(data.begin(), endElement);
+    int startIndex = std::distance(times.begin(), startElement);
+    int endIndex = std::distance(times.begin(), endElement);
 
     if (startIndex == endIndex)
         return false;
 
+    // selection curves serve the selected range of their data curves
     setReplotStatus(false);
-    for (int i=0; i<dataCurves.size(); i++)
-    {
-        QwtPlotCurve* curve  = selectionCurves[i];
-
-        for (int pos=startIndex; pos<endIndex; pos++)
-        {
-            QPointF point = dataCurves[i]->data()->sample(pos);
-
-            addPoint(curve, point);
-        }
-    }
+    for (auto selectionCurve : selectionCurves)
+        static_cast<CurveData*>(selectionCurve->data())->setRange(startIndex, endIndex);
     setReplotStatus(true);
 
     return true;
@@ -714,6 +1162,24 @@ void LineGraphWidget::mouseReleaseEvent(QMouseEvent *event)
     }
 }
 
+void LineGraphWidget::resizeEvent(QResizeEvent *event)
+{
+    QwtPlot::resizeEvent(event);
+    updateResolution();
+}
+
+/*!
+ * \brief LineGraphWidget::updateResolution limits the points drawn per curve to the canvas width
+ */
+void LineGraphWidget::updateResolution()
+{
+    int width = canvas()->width();
+    for (auto curve : dataCurves)
+        static_cast<CurveData*>(curve->data())->setResolution(width);
+    for (auto curve : selectionCurves)
+        static_cast<CurveData*>(curve->data())->setResolution(width);
+}
+
 QRectF LineGraphWidget::boundingRect() const
 {
     QRectF rect(0., 0., -1., -1.);
@@ -735,23 +1201,48 @@ QRectF LineGraphWidget::boundingRect() const
 
 double LineGraphWidget::getT(double timestamp)
 {
-    uint roundedTimestamp = qRound(timestamp);
-    return getT(roundedTimestamp) + 1000. * (timestamp - roundedTimestamp);
+    return TimeAxis::getT(timestamp);
 }
 
 double LineGraphWidget::getT(uint timestamp)
 {
-    return getT( QDateTime::fromTime_t(timestamp) );
+    return TimeAxis::getT(timestamp);
 }
 
 double LineGraphWidget::getT(QDateTime datetime)
 {
-    return QwtDate::toDouble(datetime);
+    return TimeAxis::getT(datetime);
 }
 
 uint LineGraphWidget::getTimestamp(double t)
 {
-    return QwtDate::toDateTime(t).toTime_t();
+    return TimeAxis::getTimestamp(t);
+}
+
+/*!
+ * \brief LineGraphWidget::setTimeAxis shares the x axis interval and the time coordinates of the samples with all graphs using \a value.
+ * The graph takes the interval of \a value, if it is set. The graph has to be empty.
+ * The owner of \a value adds the time coordinates of the samples before adding the vectors to the graphs.
+ */
+void LineGraphWidget::setTimeAxis(TimeAxis *value)
+{
+    Q_ASSERT(value != nullptr);
+    Q_ASSERT(dataCurves.isEmpty());
+
+    disconnect(timeAxis, nullptr, this, nullptr);
+    if (timeAxis->parent() == this)
+        delete timeAxis;
+
+    timeAxis = value;
+
+    connect(timeAxis, &TimeAxis::intervalChanged, this, [this](QwtInterval intv){
+        setAxisIntv(intv, QwtPlot::xBottom);
+    });
+
+    if (timeAxis->getInterval().isValid())
+        setAxisIntv(timeAxis->getInterval(), QwtPlot::xBottom);
+    else
+        timeAxis->setInterval(axisInterval(QwtPlot::xBottom));
 }
 
 /*!
@@ -771,31 +1262,68 @@ void LineGraphWidget::setAxisScale(int axisId, double min, double max, double st
     QwtPlot::setAxisScale(axisId, min, max, stepSize);
 }
 
-void LineGraphWidget::exportGraph(QString filePath)
+/*!
+ * \brief LineGraphWidget::getSnapshot returns the visible part of the graph for GraphExporter.
+ * The curves are decimated to the width of the exported image. The snapshot has \a size in pixels,
+ * if \a size is invalid it is the size of the graph at GRAPH_EXPORT_DPI.
+ */
+GraphSnapshot LineGraphWidget::getSnapshot(QSize size) const
 {
-    // hide tooltips
-    coordinateLabel->hide();
-    replot();
+    GraphSnapshot snapshot;
+    snapshot.scale = static_cast<double>(GRAPH_EXPORT_DPI) / logicalDpiX();
+    snapshot.size = size.isValid() ? size : this->size() * snapshot.scale;
+    snapshot.background = canvasBackground().color();
+    snapshot.xAxis = GraphSnapshot::getAxis(this, QwtPlot::xBottom);
+    snapshot.yAxis = GraphSnapshot::getAxis(this, QwtPlot::yLeft);
+    snapshot.legend = legendEntries;
 
-    int widthResolution = logicalDpiX();  //width dots per inch
-    int heightResolution = logicalDpiY();  //width dots per inch
+    const auto &xInterval = snapshot.xAxis.interval;
+    const auto &yInterval = snapshot.yAxis.interval;
 
-    double widthMM = 25.4 * static_cast<double>(size().width()) / static_cast<double>(widthResolution);
-    double heightMM = 25.4 * static_cast<double>(size().height()) / static_cast<double>(heightResolution);
-    QSizeF sizeMM(widthMM, heightMM);
+    // selection
+    if (zoneItem->isVisible())
+    {
+        QwtInterval zone = zoneItem->interval();
+        QColor zoneColor = zoneItem->brush().color();
+        snapshot.rects << GraphSnapshot::Rect{QRectF(QPointF(zone.minValue(), yInterval.minValue()), QPointF(zone.maxValue(), yInterval.maxValue())), zoneColor};
+    }
 
-    QwtPlotRenderer renderer;
-    renderer.renderDocument(this, filePath, sizeMM, 150);
+    // annotations
+    for (auto item : {userAnnotationItem, detectedAnnotationItem})
+        if (item->isVisible())
+            snapshot.rects << item->getRects(xInterval.minValue(), xInterval.maxValue());
 
-    // show tooltips again
-    coordinateLabel->show();
-    replot();
+    // curves:
+    // at most two samples per pixel of the exported image
+    QRectF rect(QPointF(xInterval.minValue(), yInterval.minValue()), QPointF(xInterval.maxValue(), yInterval.maxValue()));
+    for (auto curves : {&dataCurves, &selectionCurves})
+    {
+        for (auto curve : *curves)
+        {
+            if (!curve->isVisible())
+                continue;
+
+            const CurveData *curveData = static_cast<const CurveData *>( curve->data() );
+
+            GraphSnapshot::Series series;
+            series.pen = curve->pen();
+            series.samples = curveData->getDecimatedSamples(rect, snapshot.size.width());
+            if (curve->symbol() != nullptr)
+                series.symbolSize = curve->symbol()->size().width();
+
+            if (!series.samples.isEmpty())
+                snapshot.series << series;
+        }
+    }
+
+    return snapshot;
 }
 
 void LineGraphWidget::setupLegend(const Functionalisation &functionalisation, const std::vector<bool> &sensorFailures)
 {
     auto funcMap = functionalisation.getFuncMap(sensorFailures);
     QMap<int, QwtPlotCurve*> legendCurves;
+    legendEntries.clear();
 
     for (int i=0; i<dataCurves.size(); i++)
     {
@@ -852,9 +1380,14 @@ void LineGraphWidget::setupLegend(const Functionalisation &functionalisation, co
         list += data;
 
         legend->updateLegend(curve, list);
+        legendEntries << qMakePair(label.text(), curve->pen().color());
     }
 }
 
+/*!
+ * \brief LineGraphWidget::setZoomBase sets the bounding rect as the zoom base.
+ * The axis intervals are kept, so the replots of the zoomer are suppressed.
+ */
 void LineGraphWidget::setZoomBase()
 {
     auto b_rect = boundingRect();
@@ -863,104 +1396,26 @@ void LineGraphWidget::setZoomBase()
         auto xIntv = axisInterval(QwtPlot::xBottom);
         auto yIntv = axisInterval(QwtPlot::yLeft);
 
+        replotSuppressed = true;
         rectangleZoom->setZoomBase(b_rect.normalized());
 
         // restore axis intervals
         setAxisIntv(xIntv, QwtPlot::xBottom);
         setAxisIntv(yIntv, QwtPlot::yLeft);
+        replotSuppressed = false;
     }
 }
 
 /*!
- * \brief LineGraphWidget::setLabel creates labels from \a annotation in form of multiple AClassRectItem.
- * \param xpos
- * \param annotation
- * \a isUserAnnotation is used to determine wether a user defined or detected label should be created.
- * For class only annotations with n classes n AClassRectItem stacked on top of each other with uniform sizes are created.
+ * \brief LineGraphWidget::setLabel sets \a annotation as the label of \a timestamp. Empty annotations remove the label.
+ * \a isUserAnnotation is used to determine wether a user defined or detected label should be set.
+ * For class only annotations with n classes n rectangles stacked on top of each other with uniform sizes are drawn.
  * For numeric annotations the size of each ractangle is based on their value relative to the sum of all values.
  */
 void LineGraphWidget::setLabel(uint timestamp, Annotation annotation, bool isUserAnnotation)
 {
-    // init labelMap dependent on isUserAnnotation
-    QMap<uint, QList<AClassRectItem *>>* labelMap;
-    if (isUserAnnotation)
-        labelMap = &userDefinedClassLabels;
-    else
-        labelMap = &detectedClassLabels;
-
-    // remove old label
-    if (labelMap->contains(timestamp))
-        deleteLabel(timestamp, isUserAnnotation);
-
-    // draw new label
-    if (!annotation.isEmpty())
-    {
-        QList<aClass> classList = annotation.getClasses();
-
-        // remove numeric classes with value == 0.0 from classList
-        // delete labels with value == 0.0
-        for (int i=0; i<classList.size(); i++)
-        {
-            if (classList[i].getType() == aClass::Type::NUMERIC &&  classList[i].getValue() <= LGW_DET_CLASS_TRESH)
-            {
-                classList.removeAt(i);
-                i--;    // decrement i in order to keep i the same value for the next turn
-            }
-        }
-
-        // create new labels
-        QList<AClassRectItem*> labels;
-        Annotation drawAnnotation = Annotation ( classList.toSet() );
-        for (aClass aclass : classList)
-        {
-            auto b_rect = boundingRect();
-            auto xIntv = QwtInterval(getT(timestamp - 1), getT(timestamp + 1));
-            auto classRect = new AClassRectItem(xIntv, drawAnnotation, aclass, isUserAnnotation);
-            classRect->attach(this);
-            labels <<  classRect;
-
-        }
-        (*labelMap)[timestamp] = labels;
-    }
-}
-
-void LineGraphWidget::adjustLabels (bool isUserAnnotation)
-{
-    // init labelMap dependent on isUserAnnotation
-    QMap<uint, QList<AClassRectItem *>>* labelMap;
-    if (isUserAnnotation)
-        labelMap = &userDefinedClassLabels;
-    else
-        labelMap = &detectedClassLabels;
-
-    // adjust width of labels
-    uint prevTimestamp = 0;
-    for ( uint timestamp : labelMap->keys() )
-    {
-        long deltaT = timestamp - prevTimestamp;
-        if (deltaT == 1 || deltaT == 3)
-        {
-            for (auto rect : (*labelMap)[prevTimestamp])
-                rect->setRight(getT(prevTimestamp + 0.5 * deltaT));
-            for (auto rect : (*labelMap)[timestamp])
-                rect->setLeft(getT(prevTimestamp + 0.5 * deltaT));
-        }
-    }
-}
-
-void LineGraphWidget::deleteLabel(double t, bool isUserAnnotation)
-{
-    QMap<uint, QList<AClassRectItem *>>* labelMap;
-    if (isUserAnnotation)
-        labelMap = &userDefinedClassLabels;
-    else
-        labelMap = &detectedClassLabels;
-
-    Q_ASSERT(labelMap->contains(t));
-
-    for (auto rect : (*labelMap)[t])
-        delete rect;
-    labelMap->remove(t);
+    AnnotationItem *annotationItem = isUserAnnotation ? userAnnotationItem : detectedAnnotationItem;
+    annotationItem->setAnnotation(timestamp, annotation);
 }
 
 
@@ -977,8 +1432,6 @@ void LineGraphWidget::setReplotStatus(bool value)
 
         if (value)
         {
-            adjustLabels(true);
-            adjustLabels(false);
             setZoomBase();
             replot();
         }
@@ -1011,7 +1464,8 @@ void LineGraphWidget::initPlot(uint timestamp, MVector vector, const Functionali
 
 //        curve->setRenderHint( QwtPlotItem::RenderAntialiased, true );
 
-        curve->setData( new CurveData() );
+        CurveData *curveData = new CurveData( &timeAxis->getTimes() );
+        curve->setData( curveData );
         curve->attach( this );
 
         dataCurves << curve;
@@ -1025,12 +1479,14 @@ void LineGraphWidget::initPlot(uint timestamp, MVector vector, const Functionali
                                            QBrush(graphColor), QPen(graphColor), QSize(6, 6)));
 
 
-        selectionCurve->setData(new CurveData());
+        selectionCurve->setData(new CurveData(curveData));
         selectionCurve->attach(this);
 
         selectionCurves << selectionCurve;
     }
 
+    updateResolution();
+
     QDateTime datetime = QDateTime::fromTime_t(timestamp);
     setPrevXRange(datetime.addSecs(qRound(0.9 * LGW_AUTO_MOVE_ZONE_SIZE)), LGW_AUTO_MOVE_ZONE_SIZE);
 
@@ -1050,13 +1506,6 @@ QColor LineGraphWidget::getGraphColor(uint i, const Functionalisation &functiona
     return ENoseColor::instance().getFuncColor(functionalisation[i]);
 }
 
-void LineGraphWidget::addPoint(QwtPlotCurve *curve, QPointF point)
-{
-    CurveData *curveData = static_cast<CurveData *>( curve->data() );
-
-    curveData->append( point );
-}
-
 void LineGraphWidget::addVector(uint timestamp, MVector vector, const Functionalisation &functionalisation, const std::vector<bool> &sensorFailures)
 {
     Q_ASSERT(dataCurves.size() == 0 || vector.getSize() == dataCurves.size());
@@ -1066,22 +1515,27 @@ void LineGraphWidget::addVector(uint timestamp, MVector vector, const Functional
     if (dataCurves.size() == 0)
         initPlot(timestamp, vector, functionalisation, sensorFailures);
 
-    auto datetime = QDateTime::fromTime_t(timestamp);
     double t = getT(timestamp);
 
+    // time coordinate of the sample:
+    // added by the owner of shared time axes
+    int index = static_cast<CurveData*>(dataCurves[0]->data())->getLast();
+    if (timeAxis->getTimes().size() <= index)
+        timeAxis->appendTimestamp(timestamp);
+
     for (int i=0; i<dataCurves.size(); i++)
     {
-        QwtPlotCurve* curve = dataCurves[i];
         double value = vector[i];
         if (qIsInf(value) || value > DBL_MAX / 2)
             value = DBL_MAX / 2;
 
-        QPointF point(t, vector[i]);
-
-        addPoint(curve, point);
+        static_cast<CurveData*>(dataCurves[i]->data())->append(value);
     }
 
-    // set the zoomBase updated by addPoint
+    // replots during the following axis changes are full replots
+    int prevReplotCount = replotCount;
+
+    // set the zoomBase updated by the appended samples
     if (replotStatus)
         setZoomBase();
 
@@ -1089,17 +1543,16 @@ void LineGraphWidget::addVector(uint timestamp, MVector vector, const Functional
     bool autoMoved = autoMoveXRange(t);
 
     // add annotation labels of vector
+    bool labelsAdded = false;
     if ( !vector.userAnnotation.isEmpty() )
     {
         setLabel(timestamp, vector.userAnnotation, true);
-        if (replotStatus)
-            adjustLabels(true);
+        labelsAdded = true;
     }
     if ( !vector.detectedAnnotation.isEmpty() )
     {
         setLabel(timestamp, vector.detectedAnnotation, false);
-        if (replotStatus)
-            adjustLabels(false);
+        labelsAdded = true;
     }
 
     if (replotStatus)
@@ -1107,10 +1560,65 @@ void LineGraphWidget::addVector(uint timestamp, MVector vector, const Functional
         auto xIntv = axisInterval(QwtPlot::xBottom);
         if (qFuzzyCompare( xIntv.width(), LGW_AUTO_MOVE_ZONE_SIZE*1000 ) && xIntv.contains(t) )
             autoScale(false, true);
-        replot();
+
+        // axes unchanged:
+        // draw the new segments of the curves directly
+        if (replotCount == prevReplotCount && (labelsAdded || !drawNewSamples()))
+            scheduleReplot();
     }
 }
 
+/*!
+ * \brief LineGraphWidget::replot updates the axes and requests a replot from the RenderScheduler, unless replots are suppressed.
+ * Cancels replots scheduled by scheduleReplot().
+ */
+void LineGraphWidget::replot()
+{
+    if (replotSuppressed)
+        return;
+
+    replotTimer.stop();
+    replotCount++;
+
+    // axis intervals and the rect of interest of the curves are up to date before the graph is drawn
+    updateAxes();
+    RenderScheduler::instance().requestReplot(this);
+}
+
+/*!
+ * \brief LineGraphWidget::scheduleReplot replots the graph after at most LGW_REPLOT_INTERVAL ms.
+ * Replot requests until then are coalesced.
+ */
+void LineGraphWidget::scheduleReplot()
+{
+    if (!replotTimer.isActive())
+        replotTimer.start();
+}
+
+/*!
+ * \brief LineGraphWidget::drawNewSamples draws the segments between the last two samples of each visible data curve with the direct painter.
+ * Returns false if the segments cannot be drawn directly and a replot is needed:
+ * the OpenGL canvas has no backing store to draw into and curves served with a level of detail change their served samples with each sample.
+ */
+bool LineGraphWidget::drawNewSamples()
+{
+    if (qobject_cast<QwtPlotCanvas*>(canvas()) == nullptr)
+        return false;
+
+    for (auto curve : dataCurves)
+        if (!static_cast<CurveData*>(curve->data())->servesRange())
+            return false;
+
+    for (auto curve : dataCurves)
+    {
+        int size = static_cast<int>(curve->dataSize());
+        if (curve->isVisible() && size > 0)
+            directPainter->drawSeries(curve, std::max(0, size - 2), size - 1);
+    }
+
+    return true;
+}
+
 RelativeLineGraphWidget::RelativeLineGraphWidget(QWidget* parent):
     LineGraphWidget(parent)
 {
@@ -1200,9 +1708,153 @@ void FuncLineGraphWidget::addVector(uint timestamp, MVector vector, const Functi
 {
     Q_ASSERT(dataCurves.size() == 0 || vector.getSize() == functionalisation.getNFuncs());
 
+    // changes of the sensor failures redraw the func graph:
+    // only hide the curves of empty funcs when the graph is initialised
+    bool isNew = dataCurves.isEmpty();
+
     LineGraphWidget::addVector(timestamp, vector, functionalisation, sensorFailures);
 
-    setSensorFailures(sensorFailures, functionalisation);
+    if (isNew)
+        setSensorFailures(sensorFailures, functionalisation);
+}
+
+/*!
+ * \brief FuncLineGraphWidget::setFuncData replaces the func curves by the func vectors of \a data.
+ * The func vectors are computed from the relative vectors in parallel with the channel grouping of \a functionalisation and \a sensorFailures.
+ * The samples of existing curves are swapped in at once, curves are only recreated if the number of funcs changed.
+ * Annotation labels are kept, unless the graph was empty.
+ */
+void FuncLineGraphWidget::setFuncData(const QMap<uint, AbsoluteMVector> &data, const Functionalisation &functionalisation, const std::vector<bool> &sensorFailures, InputFunctionType inputFunctionType)
+{
+    if (data.isEmpty())
+    {
+        clearGraph();
+        return;
+    }
+
+    FunctionalisationIndex index(functionalisation, sensorFailures);
+
+    // time coordinates:
+    // shared time axes already hold the samples of data
+    if (timeAxis->getTimes().size() != data.size())
+        timeAxis->setTimestamps(data.keys());
+
+    std::vector<const AbsoluteMVector*> vectors;
+    vectors.reserve(static_cast<size_t>(data.size()));
+    for (auto it = data.constBegin(); it != data.constEnd(); it++)
+        vectors.push_back(&it.value());
+
+    int nCurves = static_cast<int>(vectors.front()->getRelativeVector().getFuncVector(index, inputFunctionType).getSize());
+
+    // one y value vector per curve,
+    // the workers write into disjoint ranges of the raw arrays
+    std::vector<QVector<double>> curveValues(static_cast<size_t>(nCurves));
+    std::vector<double*> curveYs;
+    for (auto &values : curveValues)
+    {
+        values.resize(static_cast<int>(vectors.size()));
+        curveYs.push_back(values.data());
+    }
+
+    auto computeRange = [&](size_t first, size_t last) {
+        for (size_t k=first; k<last; k++)
+        {
+            MVector funcVector = vectors[k]->getRelativeVector().getFuncVector(index, inputFunctionType);
+            for (int i=0; i<nCurves; i++)
+                curveYs[i][k] = funcVector[i];
+        }
+    };
+
+    size_t nRuns = std::min(static_cast<size_t>(std::max(1, pool.maxThreadCount())), vectors.size());
+    if (nRuns == 1)
+    {
+        computeRange(0, vectors.size());
+    }
+    else
+    {
+        QList<QFuture<void>> runs;
+        size_t rangeSize = (vectors.size() + nRuns - 1) / nRuns;
+        for (size_t run=0; run<nRuns; run++)
+        {
+            size_t first = run * rangeSize;
+            size_t last = std::min(first + rangeSize, vectors.size());
+            runs << QtConcurrent::run(&pool, [&computeRange, first, last]() {
+                computeRange(first, last);
+            });
+        }
+        for (auto &run : runs)
+            run.waitForFinished();
+    }
+
+    // swap in the new curves
+    bool graphWasEmpty = dataCurves.isEmpty();
+    if (dataCurves.size() != nCurves)
+    {
+        for (int i=0; i<dataCurves.size(); i++)
+        {
+            delete dataCurves[i];
+            delete selectionCurves[i];
+        }
+        dataCurves.clear();
+        selectionCurves.clear();
+
+        initPlot(data.firstKey(), MVector(nullptr, static_cast<size_t>(nCurves)), functionalisation, sensorFailures);
+    }
+    else
+    {
+        // funcs of the curves might have changed
+        for (int i=0; i<nCurves; i++)
+        {
+            QString graphName = getGraphName(static_cast<size_t>(i), functionalisation);
+            QColor graphColor = getGraphColor(static_cast<uint>(i), functionalisation);
+
+            dataCurves[i]->setTitle(graphName);
+            dataCurves[i]->setPen(graphColor);
+            dataCurves[i]->setSymbol( new QwtSymbol( QwtSymbol::Ellipse,
+                                               QBrush(graphColor), QPen(graphColor), QSize( 4, 4 ) ) );
+
+            selectionCurves[i]->setTitle(graphName);
+            selectionCurves[i]->setPen(graphColor);
+            selectionCurves[i]->setSymbol( new QwtSymbol( QwtSymbol::Ellipse,
+                                               QBrush(graphColor), QPen(graphColor), QSize(6, 6) ) );
+            static_cast<CurveData *>( selectionCurves[i]->data() )->clear();
+        }
+    }
+
+    QList<int> funcCounts = functionalisation.getFuncMap(sensorFailures).values();
+    for (int i=0; i<nCurves; i++)
+    {
+        static_cast<CurveData *>( dataCurves[i]->data() )->setValues(curveValues[i]);
+
+        // hide funcs without working channels
+        bool visible = i >= funcCounts.size() || funcCounts[i] > 0;
+        dataCurves[i]->setVisible(visible);
+        selectionCurves[i]->setVisible(visible);
+        dataCurves[i]->setItemAttribute(QwtPlotItem::Legend, visible);
+    }
+
+    // add annotation labels of the vectors
+    if (graphWasEmpty)
+    {
+        QMap<uint, Annotation> userAnnotations, detectedAnnotations;
+        for (auto it = data.constBegin(); it != data.constEnd(); it++)
+        {
+            if ( !it.value().userAnnotation.isEmpty() )
+                userAnnotations.insert(userAnnotations.constEnd(), it.key(), it.value().userAnnotation);
+            if ( !it.value().detectedAnnotation.isEmpty() )
+                detectedAnnotations.insert(detectedAnnotations.constEnd(), it.key(), it.value().detectedAnnotation);
+        }
+        userAnnotationItem->setAnnotations(userAnnotations);
+        detectedAnnotationItem->setAnnotations(detectedAnnotations);
+    }
+
+    setupLegend(functionalisation, sensorFailures);
+
+    if (replotStatus)
+    {
+        setZoomBase();
+        replot();
+    }
 }
 
 void FuncLineGraphWidget::setSensorFailures(const std::vector<bool> &sensorFailures, const Functionalisation &functionalisation)
@@ -1244,11 +1896,14 @@ QColor FuncLineGraphWidget::getGraphColor(uint i, const Functionalisation &funct
 void FuncLineGraphWidget::setupLegend(const Functionalisation &functionalisation, const std::vector<bool> &sensorFailures)
 {
     auto funcMap = functionalisation.getFuncMap(sensorFailures);
+    legendEntries.clear();
 
     for (int i=0; i<dataCurves.size(); i++)
     {
         if (funcMap.values()[i] == 0)
             dataCurves[i]->setItemAttribute(QwtPlotItem::Legend, false);
+        else
+            legendEntries << qMakePair(dataCurves[i]->title().text(), dataCurves[i]->pen().color());
 
         // hide selection curves from legend
         selectionCurves[i]->setItemAttribute(QwtPlotItem::Legend, false);
@@ -2,12 +2,15 @@
 #define LINEGRAPHWIDGET_H
 
 #include <QWidget>
+#include <QTimer>
 
 #include <qwt_plot.h>
 
 #include "../classes/mvector.h"
 #include "../classes/functionalisation.h"
 #include "fixedplotzoomer.h"
+#include "graphexporter.h"
+#include "timeaxis.h"
 
 #include <qwt_plot_zoomer.h>
 #include <qwt_plot_picker.h>
@@ -28,19 +31,88 @@
 #define LGW_Y_RELATIVE_MARGIN 0.15
 
 #define LGW_DET_CLASS_TRESH 0.01
+#define LGW_ANNOTATION_HALF_WIDTH 1         // seconds an annotation is drawn left and right of its timestamp
+#define LGW_ANNOTATION_ITEM_RTTI 1001
 
-class CurveData: public QwtArraySeriesData<QPointF>
+#define LGW_LOD_FACTOR 4                    // samples per block of the first detail level, blocks per block of the next level
+#define LGW_LOD_DEFAULT_RESOLUTION 2000     // max number of served blocks until the canvas width is known
+
+#define LGW_REPLOT_INTERVAL 250             // max delay in ms of a replot requested while adding vectors
+
+#define LGW_TOOLTIP_MAX_DT 6000             // max horizontal distance in ms between the cursor and a curve sample with tooltip
+
+class CurveData: public QwtSeriesData<QPointF>
 {
 public:
-    CurveData();
+    CurveData(const QVector<double> *times);
+
+    CurveData(const CurveData *source);
 
     virtual QRectF boundingRect() const override;
 
-    inline void append( const QPointF &point );
+    virtual size_t size() const override;
+
+    virtual QPointF sample(size_t i) const override;
+
+    virtual void setRectOfInterest(const QRectF &rect) override;
+
+    inline void append( double value );
 
     void clear();
 
-    QVector<QPointF>* samples();
+    void setValues(QVector<double> &values);
+
+    void setRange(int first, int last);
+
+    void setResolution(int value);
+
+    int getFirst() const;
+
+    int getLast() const;
+
+    QPointF point(int index) const;
+
+    QPair<int, int> getIndexRange(double minX, double maxX) const;
+
+    bool servesRange() const;
+
+    QVector<QPointF> getDecimatedSamples(const QRectF &rect, int maxBlocks) const;
+
+private:
+    struct Block
+    {
+        int minIndex;   // sample with the min y value of the block
+        int maxIndex;   // sample with the max y value of the block
+    };
+
+    const QVector<double> *times;   // x values shared by all curves of the graphs, see TimeAxis
+    QVector<double> values;         // y values, sample i is (times[i], values[i])
+    std::vector<std::vector<Block>> levels;     // levels[k]: blocks of LGW_LOD_FACTOR^(k+1) consecutive samples
+
+    // curves showing a range of another curve (selection curves):
+    // the samples [rangeFirst, rangeLast) of source
+    const CurveData *source = nullptr;
+    int rangeFirst = 0;
+    int rangeLast = 0;
+
+    QRectF rectOfInterest;          // normalized visible area, null: whole curve
+    int resolution = LGW_LOD_DEFAULT_RESOLUTION;
+
+    // served samples:
+    // either the range [viewFirst, viewFirst + viewSize) or the block extremes in view
+    mutable int viewFirst = 0;
+    mutable int viewSize = 0;
+    mutable bool viewBlocks = false;
+    mutable std::vector<int> view;  // indices of the served block extremes
+    mutable bool viewValid = false;
+
+    const QVector<double> &getValues() const;
+    const std::vector<std::vector<Block>> &getLevels() const;
+    void addToLevels(int index);
+    void updateBlock(Block &block, int index) const;
+    void updateView() const;
+    bool selectSamples(const QRectF &rect, int maxBlocks, int *first, int *size, std::vector<int> *indices) const;
+    QRectF samplesBoundingRect() const;
 };
 
 
@@ -63,37 +135,48 @@ protected:
     virtual QwtText trackerTextF (const QPointF &pos) const override;
 };
 
-class AClassRectItem: public QwtPlotItem
+/*!
+ * \brief The AnnotationItem class draws the user defined or detected annotations of a graph.
+ * Consecutive timestamps with equal annotations are stored as one run, which is drawn as one rectangle per class.
+ */
+class AnnotationItem: public QwtPlotItem
 {
 public:
-    AClassRectItem(QwtInterval interval, Annotation annotation, aClass aclass, bool isUserAnnotation);
+    AnnotationItem(bool isUserAnnotation);
 
-    void setInterval( QwtInterval& xValue );
-    double left();
-    void setLeft(const double &value);
-    double right();
-    void setRight(const double &value);
+    void setAnnotation(uint timestamp, const Annotation &annotation);
+
+    void setAnnotations(const QMap<uint, Annotation> &annotations);
+
+    void clear();
+
+    bool getAnnotationAt(const QPointF &pos, Annotation *annotation) const;
+
+    QList<GraphSnapshot::Rect> getRects(double minT, double maxT) const;
 
     virtual void draw( QPainter *painter,
         const QwtScaleMap &xMap, const QwtScaleMap &yMap,
         const QRectF &canvasRect ) const override;
 
-    QRectF boundingRect();
-
     int rtti() const override;
 
-    Annotation getAnnotation() const;
-
     bool getIsUserAnnotation() const;
 
-protected:
-    QwtInterval xInterval;
-    Annotation annotation;
-    aClass aclass;
+private:
+    struct Run
+    {
+        uint last;              // last timestamp of the run
+        Annotation annotation;
+    };
+
     bool isUserAnnotation;
-    mutable QRectF b_rect;
+    QMap<uint, Annotation> annotations;     // drawn annotation of each timestamp
+    QMap<uint, Run> runs;                   // runs by first timestamp, do not share timestamps
 
-    QColor getColor() const;
+    bool setDrawnAnnotation(uint timestamp, const Annotation &annotation);
+    void updateRuns(uint first, uint last);
+    QwtInterval getYInterval() const;
+    void getClassInterval(const Annotation &annotation, const aClass &aclass, const QwtInterval &yInterval, double *y1, double *y2) const;
 };
 
 class LineGraphWidget : public QwtPlot
@@ -119,13 +202,16 @@ public:
 
     uint getTimestamp(double t);
 
+    void setTimeAxis(TimeAxis *value);
+
     void setAxisScale( int axisId, double min, double max, double stepSize = 0 );
 
-    void exportGraph(QString filePath);
+    GraphSnapshot getSnapshot(QSize size = QSize()) const;
 
-signals:
-    void axisIntvSet(QwtInterval intv, QwtPlot::Axis axis);
+    virtual void replot() override;
 
+
+signals:
     void selectionMade(uint min, uint max);
 
     void selectionCleared();
@@ -161,7 +247,6 @@ public slots:
 
     void setAnnotations(const QMap<uint, Annotation> &annotations, bool isUserAnnotation);
 
-    void adjustLabels ( bool isUserAnnotation );
 
 protected slots:
     void setMouseCoordinates(const QPointF &coords);
@@ -174,8 +259,6 @@ protected slots:
 
     void setLabel(uint timestamp, Annotation annotation, bool isUserAnnotation);
 
-    void deleteLabel(double t, bool isUserAnnotation);
-
 protected:
     bool replotStatus = true;
     bool measRunning = false;
@@ -183,8 +266,8 @@ protected:
     QVector<QwtPlotCurve*> dataCurves;
     QVector<QwtPlotCurve*> selectionCurves;
 
-    QMap<uint, QList<AClassRectItem *>> userDefinedClassLabels;
-    QMap<uint, QList<AClassRectItem *>> detectedClassLabels;
+    AnnotationItem *userAnnotationItem;
+    AnnotationItem *detectedAnnotationItem;
 
     FixedPlotZoomer *rectangleZoom;
     QwtPlotPicker *zonePicker;
@@ -193,23 +276,36 @@ protected:
 
     QwtPlotTextLabel *coordinateLabel;
     QwtPlotLegendItem *legend;
+    QList<QPair<QString, QColor>> legendEntries;    // entries of legend, see setupLegend
 
     QPointF zoomBaseOffset = QPointF(2000., 1.);
 
+    TimeAxis *timeAxis;             // x axis of the line graphs, owned by the graph unless shared by setTimeAxis
+
+    QwtPlotDirectPainter *directPainter;
+    QTimer replotTimer;             // coalesces replots requested while adding vectors
+    bool replotSuppressed = false;  // true: replot() does nothing
+    int replotCount = 0;
+
     virtual void initPlot(uint timestamp, MVector vector, const Functionalisation &functionalisation, const std::vector<bool> &sensorFailures);
 
     virtual QString getGraphName(size_t i, const Functionalisation &functionalisation);
 
     virtual QColor getGraphColor(uint i, const Functionalisation &functionalisation);
 
-    void addPoint(QwtPlotCurve* curve, QPointF point);
-
     bool selectPoints(double min, double max);
 
     bool autoMoveXRange(double t);
 
     virtual void mouseReleaseEvent(QMouseEvent *event) override;
 
+    virtual void resizeEvent(QResizeEvent *event) override;
+
+    void updateResolution();
+
+    bool drawNewSamples();
+
+    void scheduleReplot();
 };
 
 class AbsoluteLineGraphWidget : public LineGraphWidget
@@ -253,6 +349,8 @@ public:
 public slots:
     void addVector(uint timestamp, MVector vector, const Functionalisation &functionalisation, const std::vector<bool> &sensorFailures) override;
 
+    void setFuncData(const QMap<uint, AbsoluteMVector> &data, const Functionalisation &functionalisation, const std::vector<bool> &sensorFailures, InputFunctionType inputFunctionType);
+
     void setSensorFailures(const std::vector<bool> &sensorFailures, const Functionalisation &functionalisation) override;
 
     void setFunctionalisation(const Functionalisation &functionalisation, const std::vector<bool> &sensorFailures) override;
@@ -262,6 +360,9 @@ public slots:
 protected:
     QString getGraphName(size_t i, const Functionalisation &functionalisation) override;
     QColor getGraphColor(uint i, const Functionalisation &functionalisation) override;
+
+private:
+    QThreadPool pool;   // computes the func curves in setFuncData
 };
 
 #endif // LINEGRAPHWIDGET_H
@@ -0,0 +1,83 @@
+#include "livefitwidget.h"
+
+#include <QVBoxLayout>
+#include <QHeaderView>
+
+#include "../classes/mvector.h"
+
+LiveFitWidget::LiveFitWidget(QWidget *parent) :
+    QWidget(parent),
+    infoLabel(new QLabel(this)),
+    resultTable(new QTableWidget(this)),
+    sensorFailures(MVector::nChannels, false)
+{
+    QVBoxLayout *layout = new QVBoxLayout;
+    layout->addWidget(infoLabel);
+    layout->addWidget(resultTable);
+    setLayout(layout);
+
+    resultTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    resultTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+
+    clear();
+}
+
+void LiveFitWidget::setData(QStringList header, QStringList tooltips, QList<QList<double>> data)
+{
+    Q_ASSERT(header.size() == tooltips.size());
+    Q_ASSERT(header.size() == data.size());
+
+    resultTable->setRowCount(MVector::nChannels);
+    resultTable->setColumnCount(data.size());
+
+    // set header
+    resultTable->setHorizontalHeaderLabels(header);
+
+    // set values & tooltips:
+    // column 0: fit valid, column 1: converged
+    for (int column=0; column<data.size(); column++)
+    {
+        resultTable->horizontalHeaderItem(column)->setToolTip(tooltips[column]);
+
+        for (int row=0; row<MVector::nChannels; row++)
+        {
+            QTableWidgetItem* item = resultTable->item(row, column);
+            if (item == nullptr)
+            {
+                item = new QTableWidgetItem;
+                resultTable->setItem(row, column, item);
+            }
+            item->setText(QString::number(data[column][row], 'g', 5));
+
+            if (static_cast<size_t>(row) < sensorFailures.size() && sensorFailures[row])
+                item->setBackgroundColor(Qt::gray);
+            else if (qFuzzyIsNull(data[0][row]))
+                item->setBackgroundColor(Qt::lightGray);
+            else if (!qFuzzyIsNull(data[1][row]))
+                item->setBackgroundColor(QColor(144, 238, 144));
+            else
+                item->setBackgroundColor(Qt::white);
+        }
+    }
+
+    if (infoLabel->text().isEmpty())
+        infoLabel->setText("Live curve fit is running...");
+}
+
+void LiveFitWidget::setSensorFailures(const std::vector<bool> &value)
+{
+    sensorFailures = value;
+}
+
+void LiveFitWidget::setConverged()
+{
+    infoLabel->setText("All channels converged: the exposition can be stopped.");
+}
+
+void LiveFitWidget::clear()
+{
+    resultTable->clear();
+    resultTable->setRowCount(0);
+    resultTable->setColumnCount(0);
+    infoLabel->setText("");
+}
@@ -0,0 +1,32 @@
+#ifndef LIVEFITWIDGET_H
+#define LIVEFITWIDGET_H
+
+#include <QtCore>
+#include <QWidget>
+#include <QLabel>
+#include <QTableWidget>
+
+/*!
+ * \brief The LiveFitWidget class shows the results of the live curve fit for each channel
+ */
+class LiveFitWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit LiveFitWidget(QWidget *parent = nullptr);
+
+public slots:
+    void setData(QStringList header, QStringList tooltips, QList<QList<double>> data);
+    void setSensorFailures(const std::vector<bool> &sensorFailures);
+    void setConverged();
+    void clear();
+
+private:
+    QLabel *infoLabel;
+    QTableWidget *resultTable;
+
+    std::vector<bool> sensorFailures;
+};
+
+#endif // LIVEFITWIDGET_H
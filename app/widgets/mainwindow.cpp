@@ -14,7 +14,9 @@
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent),
-      ui(new Ui::MainWindow)
+      ui(new Ui::MainWindow),
+      graphExporter(new GraphExporter(this)),
+      timeAxis(new TimeAxis(this))
 {
     ui->setupUi(this);
     this->setWindowIcon(QIcon(":/icons/icon"));
@@ -32,6 +34,17 @@ MainWindow::MainWindow(QWidget *parent)
     statusBar()->addPermanentWidget(statusTextLabel);
     statusBar()->addPermanentWidget(statusImageLabel);
 
+    // graph export results
+    connect(graphExporter, &GraphExporter::graphExported, this, [this](QString filePath){
+        statusBar()->showMessage(tr("Graph exported to ") + filePath, 5000);
+    });
+    connect(graphExporter, &GraphExporter::exportFailed, this, [this](QString filePath, QString errorString){
+        if (isVisible())
+            QMessageBox::critical(this, "Error exporting graph", errorString);
+        else
+            qWarning().noquote() << "Error exporting" << filePath << ":" << errorString;
+    });
+
     // prepare menubar
     ui->actionStart->setEnabled(false);
     ui->actionReset->setEnabled(false);
@@ -73,16 +86,19 @@ void MainWindow::clearGraphs()
     funcLineGraph->clearGraph();
     relLineGraph->clearGraph();
     absLineGraph->clearGraph();
+    timeAxis->clear();
 }
 
 void MainWindow::addVector(uint timestamp, AbsoluteMVector absoluteVector, const Functionalisation &functionalisation, const std::vector<bool> &sensorFailures)
 {
+    timeAxis->appendTimestamp(timestamp);
+
     absLineGraph->addVector(timestamp, absoluteVector, functionalisation, sensorFailures);
 
     RelativeMVector relativeVector = absoluteVector.getRelativeVector();
     relLineGraph->addVector(timestamp, relativeVector, functionalisation, sensorFailures);
 
-    RelativeMVector funcVector = relativeVector.getFuncVector(functionalisation, sensorFailures);
+    RelativeMVector funcVector = relativeVector.getFuncVector(functionalisation, sensorFailures, inputFunctionType);
     funcLineGraph->addVector(timestamp, funcVector, functionalisation, sensorFailures);
 }
 
@@ -91,6 +107,7 @@ void MainWindow::setData(const QMap<uint, AbsoluteMVector> &data, const Function
     absLineGraph->clearGraph();
     relLineGraph->clearGraph();
     funcLineGraph->clearGraph();
+    timeAxis->setTimestamps(data.keys());
 
     absLineGraph->setReplotStatus(false);
     relLineGraph->setReplotStatus(false);
@@ -102,8 +119,8 @@ void MainWindow::setData(const QMap<uint, AbsoluteMVector> &data, const Function
 
         RelativeMVector relVector = data[timestamp].getRelativeVector();
         relLineGraph->addVector(timestamp, relVector, functionalisation, sensorFailures);
-        funcLineGraph->addVector(timestamp, relVector.getFuncVector(functionalisation, sensorFailures), functionalisation, sensorFailures);
     }
+    funcLineGraph->setFuncData(data, functionalisation, sensorFailures, inputFunctionType);
 
     absLineGraph->setReplotStatus(true);
     relLineGraph->setReplotStatus(true);
@@ -328,16 +345,10 @@ void MainWindow::redrawFuncGraph(const QMap<uint, AbsoluteMVector> &data, const
     // store interval
     QwtInterval axisIntv = funcLineGraph->axisInterval(QwtPlot::xBottom);
 
-    // redraw func graph with updated func vectors
+    // recompute func curves with updated func vectors:
+    // absolute & relative graphs are not touched
     funcLineGraph->setReplotStatus(false);
-    funcLineGraph->clearGraph();
-    for (uint timestamp : data.keys())
-    {
-        MVector funcVector = data[timestamp].getRelativeVector().getFuncVector(functionalisation, sensorFailures);
-        funcLineGraph->addVector(timestamp, funcVector, functionalisation, sensorFailures);
-    }
-
-    funcLineGraph->setupLegend(functionalisation, sensorFailures);
+    funcLineGraph->setFuncData(data, functionalisation, sensorFailures, inputFunctionType);
     funcLineGraph->setReplotStatus(true);
 
     // restore x axis interval
@@ -373,7 +384,7 @@ void MainWindow::saveLineGraphImage(LineGraphWidget *graph)
                 filePath += "." + filter;
         }
 
-        graph->exportGraph(filePath);
+        graphExporter->exportGraph(graph->getSnapshot(), filePath);
     }
 
     settings.setValue(EXPORT_DIR_KEY, filePath);
@@ -396,7 +407,7 @@ void MainWindow::saveBarGraphImage(AbstractBarGraphWidget *graph)
                 filePath += "." + filter;
         }
 
-        graph->exportGraph(filePath);
+        graphExporter->exportGraph(graph->getSnapshot(), filePath);
 
         settings.setValue(EXPORT_DIR_KEY, filePath);
     }
@@ -447,6 +458,7 @@ void MainWindow::setSensorFailures(const QMap<uint, AbsoluteMVector> &data, cons
 {
     // info widget
     measInfoWidget->setSensorFailures(sensorFailures);
+    liveFitWidget->setSensorFailures(sensorFailures);
 
     // line graphs
     absLineGraph->setSensorFailures(sensorFailures, functionalisation);
@@ -458,6 +470,17 @@ void MainWindow::setSensorFailures(const QMap<uint, AbsoluteMVector> &data, cons
     redrawFuncGraph(data, functionalisation, sensorFailures);
 }
 
+/*!
+ * \brief MainWindow::setInputFunctionType sets the aggregation of the channels of each func in the func graph and bar chart
+ */
+void MainWindow::setInputFunctionType(InputFunctionType inputFunctionType, const QMap<uint, AbsoluteMVector> &data, const Functionalisation &functionalisation, const std::vector<bool> &sensorFailures)
+{
+    this->inputFunctionType = inputFunctionType;
+
+    if (!data.isEmpty())
+        redrawFuncGraph(data, functionalisation, sensorFailures);
+}
+
 void MainWindow::openSensorFailuresDialog(const std::vector<bool> &sensorFailures)
 {
     SetSensorFailuresDialog *sfDialog = new SetSensorFailuresDialog(sensorFailures, this);
@@ -522,6 +545,11 @@ void MainWindow::closeClassifier()
     ui->actionClassify_measurement->setEnabled(false);
 }
 
+void MainWindow::setClassifierInfo(QString info)
+{
+    classifierWidget->setInfoString(info);
+}
+
 void MainWindow::changeAnnotations( const QMap<uint, Annotation> annotations , bool isUserAnnotation )
 {
     absLineGraph->setAnnotations(annotations, isUserAnnotation);
@@ -534,7 +562,7 @@ void MainWindow::setSelectionVector ( const AbsoluteMVector &vector, const Absol
     auto relVector = vector.getRelativeVector();
     auto relStdVector = stdDevVector.getRelativeVector() + 100.;
     vectorBarGraph->setVector(relVector, relStdVector, sensorFailures, functionalisation);
-    funcBarGraph->setVector(relVector.getFuncVector(functionalisation, sensorFailures), relStdVector.getFuncVector(functionalisation, sensorFailures), sensorFailures, functionalisation);
+    funcBarGraph->setVector(relVector.getFuncVector(functionalisation, sensorFailures, inputFunctionType), relStdVector.getFuncVector(functionalisation, sensorFailures, inputFunctionType), sensorFailures, functionalisation);
 }
 
 void MainWindow::clearSelectionVector()
@@ -623,12 +651,9 @@ void MainWindow::createDockWidgets()
     //  graph connections   //
     //                      //
     // sync x-range of line graphs
-    connect(absLineGraph, &LineGraphWidget::axisIntvSet, relLineGraph, &LineGraphWidget::setAxisIntv);
-    connect(absLineGraph, &LineGraphWidget::axisIntvSet, funcLineGraph, &LineGraphWidget::setAxisIntv);
-    connect(relLineGraph, &LineGraphWidget::axisIntvSet, absLineGraph, &LineGraphWidget::setAxisIntv);
-    connect(relLineGraph, &LineGraphWidget::axisIntvSet, funcLineGraph, &LineGraphWidget::setAxisIntv);
-    connect(funcLineGraph, &LineGraphWidget::axisIntvSet, absLineGraph, &LineGraphWidget::setAxisIntv);
-    connect(funcLineGraph, &LineGraphWidget::axisIntvSet, relLineGraph, &LineGraphWidget::setAxisIntv);
+    absLineGraph->setTimeAxis(timeAxis);
+    relLineGraph->setTimeAxis(timeAxis);
+    funcLineGraph->setTimeAxis(timeAxis);
 
     // selection flow:
     connect(absLineGraph, &LineGraphWidget::selectionMade, this, &MainWindow::selectionMade);
@@ -682,12 +707,22 @@ void MainWindow::createDockWidgets()
     connect(funcBarGraph, &AbstractBarGraphWidget::errorBarsVisibleSet, vectorBarGraph, &AbstractBarGraphWidget::setErrorBarsVisible);
     connect(vectorBarGraph, &AbstractBarGraphWidget::errorBarsVisibleSet, funcBarGraph, &AbstractBarGraphWidget::setErrorBarsVisible);
 
+    // live curve fit results
+    liveFitDock = new QDockWidget(tr("Live Curve Fit"), this);
+    liveFitWidget = new LiveFitWidget;
+    liveFitDock->setAllowedAreas(Qt::RightDockWidgetArea);
+    liveFitDock->setWidget(liveFitWidget);
+    addDockWidget(Qt::RightDockWidgetArea, liveFitDock);
+    rightDocks << liveFitDock;
+    liveFitDock->hide();
+
     // add actions to view menu
     ui->menuView->addAction(flgdock->toggleViewAction());
     ui->menuView->addAction(fbgdock->toggleViewAction());
     ui->menuView->addAction(rlgdock->toggleViewAction());
     ui->menuView->addAction(algdock->toggleViewAction());
     ui->menuView->addAction(vbgdock->toggleViewAction());
+    ui->menuView->addAction(liveFitDock->toggleViewAction());
 
     // create tabs
     tabifyDockWidget(algdock, rlgdock);
@@ -823,6 +858,7 @@ void MainWindow::on_actionClassify_measurement_triggered()
 void MainWindow::on_actionLive_classifcation_triggered(bool checked)
 {
     classifierWidget->setLiveClassification(checked);
+    emit liveClassificationRequested(checked);
 }
 
 void MainWindow::setIsLiveClassificationState(bool isLive)
@@ -856,7 +892,87 @@ void MainWindow::on_actionFit_curve_triggered()
     emit fitCurvesRequested();
 }
 
+void MainWindow::on_actionLive_curve_fit_triggered(bool checked)
+{
+    if (checked)
+    {
+        liveFitWidget->clear();
+        liveFitDock->show();
+        liveFitDock->raise();
+    }
+
+    emit liveCurveFitRequested(checked);
+}
+
+void MainWindow::setLiveFitData(QStringList header, QStringList tooltips, QList<QList<double>> data)
+{
+    liveFitWidget->setData(header, tooltips, data);
+}
+
+void MainWindow::setLiveFitConverged()
+{
+    liveFitWidget->setConverged();
+    statusBar()->showMessage(tr("Live curve fit converged"), 5000);
+}
+
 void MainWindow::on_actionLabViewFile_triggered()
 {
     emit saveAsLabviewFileRequested();
 }
+
+void MainWindow::on_actionExportGraphs_triggered()
+{
+    QSettings settings(QCoreApplication::organizationName(), QCoreApplication::applicationName());
+    QString exportPath = settings.value(EXPORT_DIR_KEY, DEFAULT_EXPORT_DIR).toString();
+    QString filter;
+    QString filePath = QFileDialog::getSaveFileName(this, "Export graphs", exportPath, "png (*.png);;jpg (*.jpg);;svg (*.svg);;pdf (*.pdf)", &filter);
+
+    if (filePath.isEmpty())
+        return;
+
+    QString suffix = filter.isEmpty() ? QFileInfo(filePath).suffix() : filter.split(" ")[0];
+    if (suffix.isEmpty())
+        suffix = "png";
+    if (filePath.endsWith("." + suffix))
+        filePath.chop(suffix.size() + 1);
+
+    exportGraphs(filePath, suffix);
+    settings.setValue(EXPORT_DIR_KEY, filePath);
+}
+
+/*!
+ * \brief MainWindow::exportGraphs exports all graphs with data to basePath_<graph>.suffix, e.g. measurement_absolute.png.
+ * The snapshots of the graphs are taken immediately, the graphs are rendered in parallel by the GraphExporter.
+ * The exported images have \a size in pixels, if \a size is invalid the size of each graph at GRAPH_EXPORT_DPI.
+ * Returns the paths of the exported files.
+ */
+QStringList MainWindow::exportGraphs(QString basePath, QString suffix, QSize size)
+{
+    QList<QPair<QString, GraphSnapshot>> snapshots;
+    snapshots << qMakePair(QString("absolute"), absLineGraph->getSnapshot(size));
+    snapshots << qMakePair(QString("relative"), relLineGraph->getSnapshot(size));
+    snapshots << qMakePair(QString("func"), funcLineGraph->getSnapshot(size));
+    if (vectorBarGraph->getDataSelected())
+        snapshots << qMakePair(QString("vector"), vectorBarGraph->getSnapshot(size));
+    if (funcBarGraph->getDataSelected())
+        snapshots << qMakePair(QString("func_vector"), funcBarGraph->getSnapshot(size));
+
+    QStringList filePaths;
+    for (const auto &snapshot : snapshots)
+    {
+        QString filePath = basePath + "_" + snapshot.first + "." + suffix;
+        graphExporter->exportGraph(snapshot.second, filePath);
+        filePaths << filePath;
+    }
+
+    return filePaths;
+}
+
+/*!
+ * \brief MainWindow::waitForExports blocks until all graph exports are done.
+ * Returns the file paths and error strings of the failed exports.
+ */
+QList<QPair<QString, QString>> MainWindow::waitForExports()
+{
+    return graphExporter->waitForDone();
+}
@@ -12,6 +12,9 @@
 #include "bargraphwidget.h"
 #include "infowidget.h"
 #include "classifierwidget.h"
+#include "livefitwidget.h"
+#include "graphexporter.h"
+#include "timeaxis.h"
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class MainWindow; }
@@ -27,6 +30,10 @@ public:
 
     bool isConverterRunning() const;
 
+    QStringList exportGraphs(QString basePath, QString suffix, QSize size = QSize());
+
+    QList<QPair<QString, QString>> waitForExports();
+
 signals:
     void setConnectionRequested();
     void startRequested();
@@ -50,8 +57,10 @@ signals:
 
     void loadClassifierRequested();
     void classifyMeasurementRequested();
+    void liveClassificationRequested(bool active);
 
     void fitCurvesRequested();
+    void liveCurveFitRequested(bool active);
 
     void sensorFailuresSet(const std::vector<bool> &sensorFailures);
     void functionalisationSet(const Functionalisation &functionalisation);
@@ -82,6 +91,8 @@ public slots:
 
     void setSensorFailures(const QMap<uint, AbsoluteMVector> &data, const Functionalisation &functionalisation, const std::vector<bool> &sensorFailures);
 
+    void setInputFunctionType(InputFunctionType inputFunctionType, const QMap<uint, AbsoluteMVector> &data, const Functionalisation &functionalisation, const std::vector<bool> &sensorFailures);
+
     void openSensorFailuresDialog(const std::vector<bool> &sensorFailures);
 
     void setDataChanged(bool dataIsChanged, QString filename);
@@ -90,6 +101,8 @@ public slots:
 
     void closeClassifier();
 
+    void setClassifierInfo(QString info);
+
     void changeAnnotations( const QMap<uint, Annotation> annotations, bool isUserAnnotation );
 
     void setSelectionVector ( const AbsoluteMVector &vector, const AbsoluteMVector &stdDevVector, const std::vector<bool> &sensorFailures, const Functionalisation &functionalisation );
@@ -100,6 +113,10 @@ public slots:
 
     void resetNChannels(uint newNChannels);
 
+    void setLiveFitData(QStringList header, QStringList tooltips, QList<QList<double>> data);
+
+    void setLiveFitConverged();
+
 private slots:
     void on_actionSave_Data_As_triggered();
 
@@ -141,6 +158,8 @@ private slots:
 
     void on_actionFit_curve_triggered();
 
+    void on_actionLive_curve_fit_triggered(bool checked);
+
     void redrawFuncGraph(const QMap<uint, AbsoluteMVector> &data, const Functionalisation &functionalisation, const std::vector<bool> &sensorFailures);
 
     void setSelectionActionsEnabled(bool selectionMade);
@@ -151,8 +170,12 @@ private slots:
 
     void on_actionLabViewFile_triggered();
 
+    void on_actionExportGraphs_triggered();
+
 private:
     Ui::MainWindow *ui;
+    GraphExporter *graphExporter;
+    TimeAxis *timeAxis;                 // x axis shared by the line graphs
 
     FuncLineGraphWidget* funcLineGraph;
     AbsoluteLineGraphWidget* absLineGraph;
@@ -161,6 +184,8 @@ private:
     FuncBarGraphWidget* funcBarGraph;
     InfoWidget* measInfoWidget;
     ClassifierWidget* classifierWidget;
+    LiveFitWidget* liveFitWidget;
+    QDockWidget* liveFitDock;
 
     QList<QDockWidget*> leftDocks;
     QList<QDockWidget*> rightDocks;
@@ -170,6 +195,7 @@ private:
 
     bool dataIsChanged = false;
     bool converterRunning = false;
+    InputFunctionType inputFunctionType = InputFunctionType::medianAverage;    // aggregation of the func graph and bar chart
 
     void closeEvent (QCloseEvent *event);
 
@@ -0,0 +1,66 @@
+#include "plotcanvas.h"
+
+#include "../classes/defaultSettings.h"
+
+#include <QGLFormat>
+
+#include <qwt_plot.h>
+#include <qwt_plot_glcanvas.h>
+
+PlotCanvas::Type PlotCanvas::type = PlotCanvas::Type::raster;
+
+QMap<QString, PlotCanvas::Type> PlotCanvas::getTypeMap()
+{
+    return QMap<QString, Type>{
+        {"raster", Type::raster},
+        {"opengl", Type::openGL},
+        {"opengl_software", Type::softwareOpenGL}
+    };
+}
+
+/*!
+ * \brief PlotCanvas::loadType returns the canvas type stored in the settings, raster if the value is unknown
+ */
+PlotCanvas::Type PlotCanvas::loadType()
+{
+    QSettings settings(QCoreApplication::organizationName(), QCoreApplication::applicationName());
+    QString typeName = settings.value(PLOT_CANVAS_KEY, DEFAULT_PLOT_CANVAS).toString();
+
+    return getTypeMap().value(typeName, Type::raster);
+}
+
+/*!
+ * \brief PlotCanvas::initApplication loads the canvas type. Has to be called before the QApplication is created.
+ * softwareOpenGL makes Qt use its software OpenGL implementation (Mesa llvmpipe) instead of the GPU driver.
+ */
+void PlotCanvas::initApplication()
+{
+    type = loadType();
+
+    if (type == Type::softwareOpenGL)
+        QCoreApplication::setAttribute(Qt::AA_UseSoftwareOpenGL);
+}
+
+/*!
+ * \brief PlotCanvas::create sets a canvas of the loaded type as the canvas of \a plot and returns it.
+ * The default raster canvas of \a plot is kept if OpenGL is not available or no valid context could be created.
+ */
+QWidget *PlotCanvas::create(QwtPlot *plot)
+{
+    Q_ASSERT(plot != nullptr);
+
+    if (type != Type::raster && QGLFormat::hasOpenGL())
+    {
+        auto glCanvas = new QwtPlotGLCanvas(plot);
+        if (glCanvas->isValid())
+        {
+            plot->setCanvas(glCanvas);
+            return glCanvas;
+        }
+
+        qWarning() << "No valid OpenGL context: Falling back to the raster canvas.";
+        delete glCanvas;
+    }
+
+    return plot->canvas();
+}
@@ -0,0 +1,31 @@
+#ifndef PLOTCANVAS_H
+#define PLOTCANVAS_H
+
+#include <QtCore>
+
+class QwtPlot;
+
+/*!
+ * \brief The PlotCanvas class creates the canvases of the graphs.
+ * The canvas is either the raster QwtPlotCanvas or the OpenGL QwtPlotGLCanvas, selected in the general settings.
+ * Machines without a usable OpenGL implementation fall back to the raster canvas.
+ * The type is read once at startup: it has to be set before the QApplication is created and before the graphs attach their pickers to the canvas.
+ */
+class PlotCanvas
+{
+public:
+    enum class Type {raster, openGL, softwareOpenGL};
+
+    static QMap<QString, Type> getTypeMap();
+
+    static Type loadType();
+
+    static void initApplication();
+
+    static QWidget *create(QwtPlot *plot);
+
+private:
+    static Type type;
+};
+
+#endif // PLOTCANVAS_H
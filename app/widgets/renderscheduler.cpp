@@ -0,0 +1,94 @@
+#include "renderscheduler.h"
+
+#include "../classes/defaultSettings.h"
+
+#include <qwt_plot.h>
+
+#include <algorithm>
+
+RenderScheduler::RenderScheduler():
+    maxFps(DEFAULT_RENDER_MAX_FPS)
+{
+    frameTimer.setSingleShot(true);
+    connect(&frameTimer, &QTimer::timeout, this, &RenderScheduler::renderFrame);
+}
+
+/*!
+ * \brief RenderScheduler::requestReplot marks \a plot dirty. It is replotted with the next frame.
+ * A frame is rendered as soon as the event loop is idle, but not earlier than 1/maxFps s after the last frame.
+ */
+void RenderScheduler::requestReplot(QwtPlot *plot)
+{
+    Q_ASSERT(plot != nullptr);
+
+    requestedReplots++;
+
+    if (!dirtyPlots.contains(plot))
+        dirtyPlots << plot;
+
+    if (!frameTimer.isActive())
+    {
+        int frameTime = 1000 / maxFps;
+        int elapsed = lastFrame.isValid() ? static_cast<int>(std::min<qint64>(lastFrame.elapsed(), frameTime)) : frameTime;
+        frameTimer.start(frameTime - elapsed);
+    }
+}
+
+/*!
+ * \brief RenderScheduler::renderFrame replots all dirty graphs
+ */
+void RenderScheduler::renderFrame()
+{
+    lastFrame.start();
+
+    // graphs may request replots while replotting:
+    // those are rendered with the next frame
+    QList<QPointer<QwtPlot>> plots;
+    plots.swap(dirtyPlots);
+
+    for (auto plot : plots)
+    {
+        if (plot.isNull())
+            continue;
+
+        plot->QwtPlot::replot();
+        executedReplots++;
+    }
+
+    if (RENDER_SCHEDULER_DEBUG)
+        qDebug() << "RenderScheduler:" << getStatisticsString();
+}
+
+int RenderScheduler::getMaxFps() const
+{
+    return maxFps;
+}
+
+/*!
+ * \brief RenderScheduler::setMaxFps sets the max number of frames per second to \a value (at least 1)
+ */
+void RenderScheduler::setMaxFps(int value)
+{
+    maxFps = std::max(1, value);
+}
+
+quint64 RenderScheduler::getRequestedReplots() const
+{
+    return requestedReplots;
+}
+
+quint64 RenderScheduler::getExecutedReplots() const
+{
+    return executedReplots;
+}
+
+QString RenderScheduler::getStatisticsString() const
+{
+    return QString::number(requestedReplots) + " replots requested, " + QString::number(executedReplots) + " executed";
+}
+
+void RenderScheduler::resetStatistics()
+{
+    requestedReplots = 0;
+    executedReplots = 0;
+}
@@ -0,0 +1,61 @@
+#ifndef RENDERSCHEDULER_H
+#define RENDERSCHEDULER_H
+
+#include <QObject>
+#include <QtCore>
+
+class QwtPlot;
+
+/*!
+ * \brief The RenderScheduler class coalesces the replots of all graphs.
+ * Graphs request replots with requestReplot(), which marks them dirty. Dirty graphs are replotted once per frame,
+ * at most maxFps frames per second. The numbers of requested and executed replots are counted.
+ * Implements a singleton based on https://stackoverflow.com/a/1008289
+ */
+class RenderScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    //
+    // singleton defenitions:
+    //
+    static RenderScheduler& instance()
+    {
+        static RenderScheduler instance;    // Guaranteed to be destroyed.
+                                            // Instantiated on first use.
+        return instance;
+    }
+
+    RenderScheduler(RenderScheduler const&) = delete;
+    void operator=(RenderScheduler const&) = delete;
+
+    //
+    //  functionality definitions
+    //
+    void requestReplot(QwtPlot *plot);
+
+    int getMaxFps() const;
+    void setMaxFps(int value);
+
+    quint64 getRequestedReplots() const;
+    quint64 getExecutedReplots() const;
+    QString getStatisticsString() const;
+    void resetStatistics();
+
+private slots:
+    void renderFrame();
+
+private:
+    RenderScheduler();
+
+    QList<QPointer<QwtPlot>> dirtyPlots;
+    QTimer frameTimer;
+    QElapsedTimer lastFrame;
+    int maxFps;
+
+    quint64 requestedReplots = 0;
+    quint64 executedReplots = 0;
+};
+
+#endif // RENDERSCHEDULER_H
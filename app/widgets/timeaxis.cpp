@@ -0,0 +1,89 @@
+#include "timeaxis.h"
+
+#include <qwt_date.h>
+
+#include <cmath>
+
+TimeAxis::TimeAxis(QObject *parent):
+    QObject(parent)
+{
+}
+
+QwtInterval TimeAxis::getInterval() const
+{
+    return interval;
+}
+
+/*!
+ * \brief TimeAxis::setInterval sets the visible time interval and notifies the graphs, if it changed.
+ * Graphs applying the interval report it back unchanged, which ends the update.
+ */
+void TimeAxis::setInterval(QwtInterval value)
+{
+    value = value.normalized();
+    if (value == interval)
+        return;
+
+    interval = value;
+    emit intervalChanged(interval);
+}
+
+/*!
+ * \brief TimeAxis::appendTimestamp adds the time coordinate of the sample at \a timestamp.
+ * Samples have to be appended in ascending order of their timestamps.
+ */
+void TimeAxis::appendTimestamp(uint timestamp)
+{
+    times << getT(timestamp);
+}
+
+/*!
+ * \brief TimeAxis::setTimestamps replaces the time coordinates of the samples by the ones of \a timestamps, which have to be sorted
+ */
+void TimeAxis::setTimestamps(const QList<uint> &timestamps)
+{
+    times.clear();
+    times.reserve(timestamps.size());
+    for (uint timestamp : timestamps)
+        times << getT(timestamp);
+}
+
+void TimeAxis::clear()
+{
+    times.clear();
+}
+
+const QVector<double> &TimeAxis::getTimes() const
+{
+    return times;
+}
+
+/*!
+ * \brief TimeAxis::getT returns the time coordinate of \a timestamp in ms since the epoch.
+ * Equal to QwtDate::toDouble(QDateTime::fromTime_t(timestamp)) without creating a QDateTime.
+ */
+double TimeAxis::getT(uint timestamp)
+{
+    return 1000. * static_cast<double>(timestamp);
+}
+
+double TimeAxis::getT(double timestamp)
+{
+    return 1000. * timestamp;
+}
+
+double TimeAxis::getT(QDateTime datetime)
+{
+    return QwtDate::toDouble(datetime);
+}
+
+/*!
+ * \brief TimeAxis::getTimestamp returns the timestamp in s of the time coordinate \a t, rounded down to full seconds
+ */
+uint TimeAxis::getTimestamp(double t)
+{
+    if (t <= 0.)
+        return 0;
+
+    return static_cast<uint>(std::floor(t / 1000.));
+}
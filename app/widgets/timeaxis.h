@@ -0,0 +1,51 @@
+#ifndef TIMEAXIS_H
+#define TIMEAXIS_H
+
+#include <QObject>
+#include <QtCore>
+
+#include <qwt_interval.h>
+
+/*!
+ * \brief The TimeAxis class is the x axis shared by the line graphs: the visible time interval and the time coordinates of the samples.
+ * Graphs observe intervalChanged and report their own x axis changes with setInterval,
+ * so each pan or zoom updates the model once instead of every graph notifying every other graph.
+ * The time coordinate t of a timestamp is the time in ms since the epoch, as used by QwtDate. It is computed once per sample.
+ */
+class TimeAxis : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit TimeAxis(QObject *parent = nullptr);
+
+    QwtInterval getInterval() const;
+
+    void appendTimestamp(uint timestamp);
+
+    void setTimestamps(const QList<uint> &timestamps);
+
+    void clear();
+
+    const QVector<double> &getTimes() const;
+
+    static double getT(uint timestamp);
+
+    static double getT(double timestamp);
+
+    static double getT(QDateTime datetime);
+
+    static uint getTimestamp(double t);
+
+signals:
+    void intervalChanged(QwtInterval interval);
+
+public slots:
+    void setInterval(QwtInterval interval);
+
+private:
+    QwtInterval interval;
+    QVector<double> times;      // time coordinate of each sample in ascending order
+};
+
+#endif // TIMEAXIS_H
@@ -0,0 +1,67 @@
+TEMPLATE = app
+QT       += core gui svg opengl
+
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets printsupport
+
+CONFIG += c++14 console
+CONFIG -= app_bundle
+QMAKE_CXXFLAGS += -D_GLIBCXX_USE_CXX11_ABI=0 -DDLIB_NO_GUI_SUPPORT
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+TARGET = classifierbenchmark
+
+APP_DIR = $$PWD/../../app
+
+SOURCES += \
+    main.cpp \
+    $$APP_DIR/classes/aclass.cpp \
+    $$APP_DIR/classes/annotation.cpp \
+    $$APP_DIR/classes/batchedleastsquaresfitter.cpp \
+    $$APP_DIR/classes/enosecolor.cpp \
+    $$APP_DIR/classes/fitmodelregistry.cpp \
+    $$APP_DIR/classes/functionalisation.cpp \
+    $$APP_DIR/classes/functionalisationindex.cpp \
+    $$APP_DIR/classes/leastsquaresfitter.cpp \
+    $$APP_DIR/classes/measurementdata.cpp \
+    $$APP_DIR/classes/mvector.cpp \
+    $$APP_DIR/classes/torchclassifier.cpp \
+    $$APP_DIR/lib/dlib/dlib/all/source.cpp \
+
+HEADERS += \
+    $$APP_DIR/classes/aclass.h \
+    $$APP_DIR/classes/annotation.h \
+    $$APP_DIR/classes/batchedleastsquaresfitter.h \
+    $$APP_DIR/classes/defaultSettings.h \
+    $$APP_DIR/classes/enosecolor.h \
+    $$APP_DIR/classes/fitmodelregistry.h \
+    $$APP_DIR/classes/fitmodels.h \
+    $$APP_DIR/classes/functionalisation.h \
+    $$APP_DIR/classes/functionalisationindex.h \
+    $$APP_DIR/classes/leastsquaresfitter.h \
+    $$APP_DIR/classes/measurementdata.h \
+    $$APP_DIR/classes/mvector.h \
+    $$APP_DIR/classes/torchclassifier.h \
+
+# libtorch
+win32: LIBS += -L$$APP_DIR/lib/libtorch/lib -ltorch -lc10 -ltorch_cpu
+unix:!macx: LIBS += -L$$APP_DIR/lib/libtorch/lib -ltorch -lc10 -ltorch_cpu
+unix:!macx: QMAKE_RPATHDIR += $$APP_DIR/lib/libtorch/lib
+
+INCLUDEPATH += $$APP_DIR/lib/libtorch/include
+DEPENDPATH += $$APP_DIR/lib/libtorch/include
+INCLUDEPATH += $$APP_DIR/lib/libtorch/include/torch/csrc/api/include
+DEPENDPATH += $$APP_DIR/lib/libtorch/include/torch/csrc/api/include
+
+# dlib
+INCLUDEPATH += $$APP_DIR/lib/dlib
+DEPENDPATH += $$APP_DIR/lib/dlib
+
+# qwt: headers only (mvector.cpp includes linegraphwidget.h)
+unix: QWT_ROOT = /usr/local/qwt-6.1.5
+win32: QWT_ROOT = C:/qwt-6.1.5
+
+include ( $$QWT_ROOT/features/qwt.prf )
+LIBS += -L$$QWT_ROOT/lib -lqwt
+INCLUDEPATH += $$QWT_ROOT/include
+DEPENDPATH += $$QWT_ROOT/include
@@ -0,0 +1,175 @@
+#include <QApplication>
+#include <QtCore>
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+
+#include "../../app/classes/torchclassifier.h"
+
+#define CLASSIFIERBENCH_DEFAULT_SAMPLES 2000
+#define CLASSIFIERBENCH_DEFAULT_BATCH_SIZES "1,8,32,256"
+#define CLASSIFIERBENCH_DEFAULT_SEED 42
+
+/*!
+ * \brief percentile returns the \a p percentile of \a values (0 <= p <= 1)
+ */
+static double percentile(std::vector<double> values, double p)
+{
+    if (values.empty())
+        return 0.;
+
+    std::sort(values.begin(), values.end());
+    return values[static_cast<size_t>(p * (values.size() - 1))];
+}
+
+/*!
+ * \brief latencyResult summarises the per-sample latencies in µs
+ */
+static QJsonObject latencyResult(QString method, int batchSize, const std::vector<double> &latencies)
+{
+    double sum = 0.;
+    for (double latency : latencies)
+        sum += latency;
+
+    QJsonObject result;
+    result["method"] = method;
+    result["batch_size"] = batchSize;
+    result["samples"] = static_cast<int>(latencies.size());
+    result["latency_mean_us"] = latencies.empty() ? 0. : sum / latencies.size();
+    result["latency_median_us"] = percentile(latencies, 0.5);
+    result["latency_p95_us"] = percentile(latencies, 0.95);
+    result["samples_per_second"] = sum > 0. ? latencies.size() / sum * 1e6 : 0.;
+
+    qInfo().noquote() << method << "batch size" << batchSize << ":" << result["latency_median_us"].toDouble() << "µs/sample (median)";
+    return result;
+}
+
+int main(int argc, char *argv[])
+{
+    QApplication a(argc, argv);
+    a.setApplicationName("classifierbenchmark");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Measures the per-sample latency of a TorchScript classifier loaded by TorchClassifier.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("model", "TorchScript classifier file (*.pt).");
+
+    QCommandLineOption inputsOption("inputs", "Number of model inputs N.", "n", "8");
+    QCommandLineOption samplesOption("samples", "Number of random input vectors.", "n", QString::number(CLASSIFIERBENCH_DEFAULT_SAMPLES));
+    QCommandLineOption batchSizesOption("batch_sizes", "Comma-separated batch sizes of getAnnotations.", "sizes", CLASSIFIERBENCH_DEFAULT_BATCH_SIZES);
+    QCommandLineOption threadsOption("threads", "Torch intra-op threads, torch default if not set.", "n");
+    QCommandLineOption seedOption("seed", "Seed of the random number generator.", "seed", QString::number(CLASSIFIERBENCH_DEFAULT_SEED));
+    QCommandLineOption outputOption("output", "JSON output file. Defaults to stdout.", "file");
+
+    parser.addOptions({inputsOption, samplesOption, batchSizesOption, threadsOption, seedOption, outputOption});
+    parser.process(a);
+
+    if (parser.positionalArguments().size() != 1)
+        parser.showHelp(1);
+
+    int nInputs = parser.value(inputsOption).toInt();
+    int nSamples = parser.value(samplesOption).toInt();
+    if (nInputs <= 0 || nSamples <= 0)
+    {
+        std::cerr << "Error: inputs and samples have to be positive" << std::endl;
+        return 1;
+    }
+    if (parser.isSet(threadsOption))
+        at::set_num_threads(parser.value(threadsOption).toInt());
+
+    // load classifier
+    bool loadOk;
+    QString errorString;
+    TorchClassifier classifier(nullptr, parser.positionalArguments().first(), &loadOk, &errorString, nInputs);
+    if (!loadOk)
+    {
+        std::cerr << "Error loading model: " << errorString.toStdString() << std::endl;
+        return 1;
+    }
+
+    // random inputs
+    std::mt19937 generator(parser.value(seedOption).toUInt());
+    std::normal_distribution<double> distribution(0., 1.);
+    // windowed models take W func vectors per input
+    std::vector<std::vector<double>> inputs(nSamples, std::vector<double>(classifier.getW() * nInputs));
+    for (auto &input : inputs)
+        for (double &value : input)
+            value = distribution(generator);
+
+    QJsonArray results;
+    try {
+        // warm up
+        classifier.getAnnotations(inputs);
+
+        // single sample path
+        std::vector<double> latencies;
+        QElapsedTimer timer;
+        for (const auto &input : inputs)
+        {
+            timer.start();
+            classifier.getAnnotation(input);
+            latencies.push_back(timer.nsecsElapsed() / 1e3);
+        }
+        results.append(latencyResult("getAnnotation", 1, latencies));
+
+        // batched path:
+        // latency per sample = time of the batch / batch size
+        for (QString batchSizeString : parser.value(batchSizesOption).split(",", QString::SkipEmptyParts))
+        {
+            int batchSize = batchSizeString.trimmed().toInt();
+            if (batchSize <= 0)
+                continue;
+
+            latencies.clear();
+            for (size_t first=0; first<inputs.size(); first+=batchSize)
+            {
+                size_t last = std::min(first + batchSize, inputs.size());
+                std::vector<std::vector<double>> batch(inputs.begin()+first, inputs.begin()+last);
+
+                timer.start();
+                classifier.getAnnotations(batch, batchSize);
+                double batchLatency = timer.nsecsElapsed() / 1e3;
+
+                for (size_t i=first; i<last; i++)
+                    latencies.push_back(batchLatency / (last - first));
+            }
+            results.append(latencyResult("getAnnotations", batchSize, latencies));
+        }
+    } catch (std::exception &e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    QJsonObject machine;
+    machine["cpu"] = QSysInfo::currentCpuArchitecture();
+    machine["os"] = QSysInfo::prettyProductName();
+    machine["torch_threads"] = at::get_num_threads();
+
+    QJsonObject result;
+    result["date"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    result["machine"] = machine;
+    result["model"] = classifier.getName();
+    result["inputs"] = nInputs;
+    result["window"] = classifier.getW();
+    result["classes"] = classifier.getM();
+    result["results"] = results;
+
+    QByteArray json = QJsonDocument(result).toJson();
+    if (parser.isSet(outputOption))
+    {
+        QFile file(parser.value(outputOption));
+        if (!file.open(QIODevice::WriteOnly))
+        {
+            std::cerr << "Error: Cannot open " << parser.value(outputOption).toStdString() << std::endl;
+            return 1;
+        }
+        file.write(json);
+    }
+    else
+    {
+        std::cout << json.toStdString();
+    }
+
+    return 0;
+}
@@ -0,0 +1,317 @@
+#include "fitbenchmark.h"
+
+#include <algorithm>
+#include <memory>
+
+#include "../../app/classes/batchedleastsquaresfitter.h"
+#include "../../app/classes/curvefitworker.h"
+
+FitBenchmark::FitBenchmark(const Settings &settings):
+    settings(settings),
+    generator(settings.seed)
+{
+}
+
+/*!
+ * \brief FitBenchmark::runSynthetic fits synthetic channels for each noise level with solve, solve_lm and the batched fit.
+ * Reports fits per second and the errors of the plateau, tau90 and the parameters relative to the known parameters.
+ */
+QJsonArray FitBenchmark::runSynthetic()
+{
+    QJsonArray results;
+
+    for (double noise : settings.noiseLevels)
+    {
+        auto channels = generateChannels(noise);
+
+        for (QString algorithm : QStringList{"solve", "solve_lm", "batched"})
+        {
+            std::vector<std::vector<double>> params(channels.size());
+            std::vector<bool> valid(channels.size(), false);
+
+            QElapsedTimer timer;
+            timer.start();
+
+            if (algorithm == "batched")
+            {
+                for (size_t first=0; first<channels.size(); first+=BATCHED_FIT_DEFAULT_BATCH_SIZE)
+                {
+                    size_t last = std::min(first + BATCHED_FIT_DEFAULT_BATCH_SIZE, channels.size());
+
+                    std::vector<std::vector<std::pair<double, double>>> channelSamples;
+                    for (size_t c=first; c<last; c++)
+                        channelSamples.push_back(channels[c].samples);
+
+                    BatchedLeastSquaresFitter<ADGSuperposModel> fitter(channelSamples);
+                    fitter.solve_lm(settings.nIterations);
+
+                    for (size_t c=first; c<last; c++)
+                    {
+                        valid[c] = fitter.isValid(c - first);
+                        params[c] = fitter.getParams(c - first);
+                    }
+                }
+            }
+            else
+            {
+                for (size_t c=0; c<channels.size(); c++)
+                {
+                    ADG_superpos_Fitter fitter;
+                    if (algorithm == "solve")
+                        fitter.solve(channels[c].samples, settings.nIterations);
+                    else
+                        fitter.solve_lm(channels[c].samples, settings.nIterations);
+
+                    valid[c] = fitter.parameters_valid(LEAST_SQUARES_LIMIT_FACTOR * channels[c].samples.back().second);
+                    params[c] = fitter.getParams();
+                }
+            }
+
+            results.append(evaluate(algorithm, noise, channels, params, valid, timer.nsecsElapsed()));
+            qInfo().noquote() << "synthetic" << algorithm << "noise" << noise << ":" << results.last().toObject()["fits_per_second"].toDouble() << "fits/s";
+        }
+    }
+
+    return results;
+}
+
+/*!
+ * \brief FitBenchmark::runScaling fits all channels of \param mData with AutomatedFitWorker for each thread count up to settings.maxThreads.
+ * Each thread count is measured with and without batched fits, the result cache is turned off.
+ * Runs terminated by the timeout of AutomatedFitWorker are marked with timed_out and report no time.
+ */
+QJsonArray FitBenchmark::runScaling(MeasurementData *mData, QString name, int tOffset, int tExposition)
+{
+    QJsonArray results;
+
+    for (bool batched : {false, true})
+    {
+        for (int nThreads : threadCounts(settings.maxThreads))
+        {
+            AutomatedFitWorker fitWorker(mData, -1, nThreads, tExposition, -1, tOffset, batched, LeastSquaresFitter::Type::SUPERPOS, false);
+
+            QElapsedTimer timer;
+            timer.start();
+            bool finished = fitWorker.fit();
+            double wallTime = timer.nsecsElapsed() / 1e9;
+
+            // runs of a timed out fit are still running:
+            // wait for them before the next measurement
+            QThreadPool::globalInstance()->waitForDone();
+
+            QJsonObject result;
+            result["measurement"] = name;
+            result["channels"] = static_cast<int>(mData->nChannels());
+            result["threads"] = nThreads;
+            result["batched"] = batched;
+            result["timed_out"] = !finished;
+            if (finished)
+            {
+                result["wall_time_s"] = wallTime;
+                result["fits_per_second"] = mData->nChannels() / wallTime;
+            }
+            results.append(result);
+
+            if (finished)
+                qInfo().noquote() << name << "threads" << nThreads << (batched ? "batched" : "") << ":" << wallTime << "s";
+            else
+                qWarning().noquote() << name << "threads" << nThreads << (batched ? "batched" : "") << ": timed out";
+        }
+    }
+
+    return results;
+}
+
+/*!
+ * \brief FitBenchmark::runSyntheticScaling measures the thread scaling on a synthetic measurement with the median noise level
+ */
+QJsonArray FitBenchmark::runSyntheticScaling()
+{
+    if (settings.noiseLevels.isEmpty())
+        return QJsonArray();
+
+    auto noiseLevels = settings.noiseLevels;
+    std::sort(noiseLevels.begin(), noiseLevels.end());
+    double noise = noiseLevels[noiseLevels.size() / 2];
+
+    std::unique_ptr<MeasurementData> mData(generateMeasurement(noise));
+
+    return runScaling(mData.get(), "synthetic (noise " + QString::number(noise) + ")", FITBENCH_DEFAULT_BASELINE, -1);
+}
+
+/*!
+ * \brief FitBenchmark::runCorpus measures the thread scaling for each measurement file (*.csv, *.txt) in \param directory.
+ * The expositions are determined by settings.tOffset and settings.tExposition as with the command line options t_offset and t_exposition.
+ */
+QJsonArray FitBenchmark::runCorpus(QString directory)
+{
+    QJsonArray results;
+
+    QDir dir(directory);
+    if (!dir.exists())
+        throw std::runtime_error("Corpus directory " + directory.toStdString() + " does not exist!");
+
+    for (QFileInfo fileInfo : dir.entryInfoList(QStringList{"*.csv", "*.txt"}, QDir::Files, QDir::Name))
+    {
+        FileReader generalFileReader(fileInfo.absoluteFilePath());
+        FileReader* specificReader = generalFileReader.getSpecificReader();
+
+        QObject::connect(specificReader, &FileReader::resetNChannels, [](uint nChannels){ MVector::nChannels = nChannels; });
+        specificReader->readFile();
+
+        MeasurementData* mData = specificReader->getMeasurementData();
+        if (mData->getAbsoluteData().isEmpty())
+        {
+            qWarning() << fileInfo.fileName() << "is empty, skipped";
+            delete specificReader;
+            continue;
+        }
+
+        for (auto result : runScaling(mData, fileInfo.fileName(), settings.tOffset, settings.tExposition))
+            results.append(result);
+
+        delete specificReader;
+    }
+
+    return results;
+}
+
+/*!
+ * \brief FitBenchmark::threadCounts returns 1, 2, 4, ... up to \param maxThreads (always included)
+ */
+QList<int> FitBenchmark::threadCounts(int maxThreads)
+{
+    QList<int> counts;
+    for (int n=1; n<maxThreads; n*=2)
+        counts << n;
+    counts << std::max(maxThreads, 1);
+
+    return counts;
+}
+
+/*!
+ * \brief FitBenchmark::generateChannels generates settings.nChannels channels following the ADG superposition model.
+ * Gaussian noise with a standard deviation of \param noise * plateau is added to each sample.
+ */
+std::vector<FitBenchmark::Channel> FitBenchmark::generateChannels(double noise)
+{
+    std::uniform_real_distribution<double> alpha_1(1., 5.), beta_1(0.02, 0.1), alpha_2(0.5, 2.), beta_2(0.002, 0.01), t0(-2., 2.);
+
+    std::vector<Channel> channels(settings.nChannels);
+    for (auto &channel : channels)
+    {
+        channel.parameters = {alpha_1(generator), beta_1(generator), t0(generator), alpha_2(generator), beta_2(generator), t0(generator)};
+
+        ADG_superpos_Fitter model;
+        model.setParams(channel.parameters);
+
+        double plateau = channel.parameters[0] + channel.parameters[3];
+        std::normal_distribution<double> noiseDistribution(0., noise * plateau);
+
+        for (int t=0; t<settings.duration; t++)
+            channel.samples.push_back(std::pair<double, double>(t, model.model(t) + noiseDistribution(generator)));
+    }
+
+    return channels;
+}
+
+/*!
+ * \brief FitBenchmark::generateMeasurement generates a measurement with a baseline of FITBENCH_DEFAULT_BASELINE seconds followed by synthetic expositions.
+ * The caller takes ownership.
+ */
+MeasurementData *FitBenchmark::generateMeasurement(double noise)
+{
+    MVector::nChannels = settings.nChannels;
+    MeasurementData *mData = new MeasurementData(nullptr, settings.nChannels);
+
+    auto channels = generateChannels(noise);
+
+    AbsoluteMVector baseVector;
+    for (int c=0; c<settings.nChannels; c++)
+        baseVector[c] = 1000.;
+
+    std::normal_distribution<double> baselineNoise(0., noise);
+    uint startTimestamp = QDateTime::currentDateTime().toTime_t();
+    for (int t=0; t<FITBENCH_DEFAULT_BASELINE + settings.duration; t++)
+    {
+        AbsoluteMVector vector;
+        for (int c=0; c<settings.nChannels; c++)
+        {
+            // relative deviation in %
+            double y = t < FITBENCH_DEFAULT_BASELINE ? baselineNoise(generator) : channels[c].samples[t - FITBENCH_DEFAULT_BASELINE].second;
+            vector[c] = baseVector[c] * (1 + y / 100);
+        }
+
+        mData->addVector(startTimestamp + t, vector, baseVector);
+    }
+
+    return mData;
+}
+
+QJsonObject FitBenchmark::evaluate(QString algorithm, double noise, const std::vector<Channel> &channels, const std::vector<std::vector<double> > &results, const std::vector<bool> &valid, qint64 nsecs) const
+{
+    std::vector<double> plateauErrors, tau90Errors, parameterErrors;
+    int nValid = 0;
+
+    for (size_t c=0; c<channels.size(); c++)
+    {
+        if (!valid[c])
+            continue;
+        nValid++;
+
+        ADG_superpos_Fitter expected, actual;
+        expected.setParams(channels[c].parameters);
+        actual.setParams(results[c]);
+
+        plateauErrors.push_back(std::abs(actual.f_t_90() - expected.f_t_90()) / std::abs(expected.f_t_90()));
+        tau90Errors.push_back(std::abs(actual.tau_90() - expected.tau_90()) / std::abs(expected.tau_90()));
+        parameterErrors.push_back(parameterError(channels[c].parameters, results[c]));
+    }
+
+    double wallTime = nsecs / 1e9;
+
+    QJsonObject result;
+    result["algorithm"] = algorithm;
+    result["noise"] = noise;
+    result["channels"] = static_cast<int>(channels.size());
+    result["valid"] = nValid;
+    result["wall_time_s"] = wallTime;
+    result["fits_per_second"] = channels.size() / wallTime;
+    result["plateau_error_median"] = median(plateauErrors);
+    result["tau90_error_median"] = median(tau90Errors);
+    result["tau90_error_max"] = tau90Errors.empty() ? 0. : *std::max_element(tau90Errors.begin(), tau90Errors.end());
+    result["parameter_error_median"] = median(parameterErrors);
+
+    return result;
+}
+
+/*!
+ * \brief FitBenchmark::parameterError returns the mean relative error of alpha_1, beta_1, alpha_2 and beta_2.
+ * The exponential terms are sorted by beta before comparison, because the order of the terms in the fit result is arbitrary.
+ * t0_1 and t0_2 are ignored, their expected values are close to zero.
+ */
+double FitBenchmark::parameterError(std::vector<double> expected, std::vector<double> actual)
+{
+    auto sortTerms = [](std::vector<double> &params) {
+        if (params[1] < params[4])
+            std::swap_ranges(params.begin(), params.begin()+3, params.begin()+3);
+    };
+    sortTerms(expected);
+    sortTerms(actual);
+
+    double error = 0.;
+    for (int i : {0, 1, 3, 4})
+        error += std::abs(actual[i] - expected[i]) / std::abs(expected[i]) / 4;
+
+    return error;
+}
+
+double FitBenchmark::median(std::vector<double> values)
+{
+    if (values.empty())
+        return 0.;
+
+    std::sort(values.begin(), values.end());
+    size_t n = values.size();
+    return n % 2 == 1 ? values[n/2] : (values[n/2-1] + values[n/2]) / 2;
+}
@@ -0,0 +1,72 @@
+#ifndef FITBENCHMARK_H
+#define FITBENCHMARK_H
+
+#include <random>
+#include <vector>
+
+#include <QtCore>
+
+#include "../../app/classes/leastsquaresfitter.h"
+#include "../../app/classes/measurementdata.h"
+
+#define FITBENCH_DEFAULT_CHANNELS 64
+#define FITBENCH_DEFAULT_DURATION 600       // exposition length of synthetic channels in s
+#define FITBENCH_DEFAULT_BASELINE 30        // length of the baseline before synthetic expositions in s
+#define FITBENCH_DEFAULT_NOISE "0.005,0.02,0.05"
+#define FITBENCH_DEFAULT_SEED 42
+
+/*!
+ * \brief The FitBenchmark class measures speed and accuracy of the curve fit.
+ * Synthetic channels follow the ADG superposition model with known parameters and gaussian noise,
+ * real measurements are fitted with AutomatedFitWorker like the --curve-fit command line option.
+ * All results are returned as JSON objects.
+ */
+class FitBenchmark
+{
+public:
+    struct Settings
+    {
+        int nChannels = FITBENCH_DEFAULT_CHANNELS;
+        int duration = FITBENCH_DEFAULT_DURATION;
+        QList<double> noiseLevels;
+        int nIterations = LEAST_SQUARES_N_FITS;
+        int maxThreads = QThread::idealThreadCount();
+        int tOffset = 0;
+        int tExposition = -1;
+        uint seed = FITBENCH_DEFAULT_SEED;
+    };
+
+    explicit FitBenchmark(const Settings &settings);
+
+    QJsonArray runSynthetic();
+
+    QJsonArray runScaling(MeasurementData *mData, QString name, int tOffset, int tExposition);
+
+    QJsonArray runSyntheticScaling();
+
+    QJsonArray runCorpus(QString directory);
+
+    static QList<int> threadCounts(int maxThreads);
+
+private:
+    struct Channel
+    {
+        std::vector<double> parameters;
+        std::vector<std::pair<double, double>> samples;
+    };
+
+    Settings settings;
+    std::mt19937 generator;
+
+    std::vector<Channel> generateChannels(double noise);
+
+    MeasurementData* generateMeasurement(double noise);
+
+    QJsonObject evaluate(QString algorithm, double noise, const std::vector<Channel> &channels, const std::vector<std::vector<double>> &results, const std::vector<bool> &valid, qint64 nsecs) const;
+
+    static double parameterError(std::vector<double> expected, std::vector<double> actual);
+
+    static double median(std::vector<double> values);
+};
+
+#endif // FITBENCHMARK_H
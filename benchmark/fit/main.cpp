@@ -0,0 +1,110 @@
+#include <QApplication>
+#include <QtCore>
+
+#include <iostream>
+
+#include "fitbenchmark.h"
+
+static bool verbose = false;
+
+void messageHandler(QtMsgType type, const QMessageLogContext &, const QString &message)
+{
+    // qDebug output of the curve fit is only shown with --verbose
+    if (type == QtDebugMsg && !verbose)
+        return;
+
+    std::cerr << message.toStdString() << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    QApplication a(argc, argv);
+    a.setApplicationName("fitbenchmark");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Measures speed and accuracy of the eNoseAnnotator curve fit.\n"
+                                     "Synthetic channels with known parameters are fitted for each noise level. "
+                                     "The thread scaling of the automated curve fit is measured on a synthetic measurement and on each measurement file in the corpus directory.");
+    parser.addHelpOption();
+
+    QCommandLineOption channelsOption("channels", "Number of synthetic channels.", "n", QString::number(FITBENCH_DEFAULT_CHANNELS));
+    QCommandLineOption durationOption("duration", "Exposition length of synthetic channels in s.", "s", QString::number(FITBENCH_DEFAULT_DURATION));
+    QCommandLineOption noiseOption("noise", "Comma-separated noise levels relative to the plateau of synthetic channels.", "levels", FITBENCH_DEFAULT_NOISE);
+    QCommandLineOption iterationsOption("iterations", "Number of random starts per fit.", "n", QString::number(LEAST_SQUARES_N_FITS));
+    QCommandLineOption threadsOption("threads", "Maximum number of threads for the scaling benchmark.", "n", QString::number(QThread::idealThreadCount()));
+    QCommandLineOption seedOption("seed", "Seed of the random number generator.", "seed", QString::number(FITBENCH_DEFAULT_SEED));
+    QCommandLineOption corpusOption("corpus", "Directory of measurement files (*.csv, *.txt) for the scaling benchmark.", "dir");
+    QCommandLineOption tOffsetOption("t_offset", "Time in s between the start of corpus measurements and their exposition.", "s", "0");
+    QCommandLineOption tExpositionOption("t_exposition", "Exposition length of corpus measurements in s. Defaults to the rest of the measurement.", "s", "-1");
+    QCommandLineOption outputOption("output", "JSON output file. Defaults to stdout.", "file");
+    QCommandLineOption verboseOption("verbose", "Show debug output of the curve fit.");
+
+    parser.addOptions({channelsOption, durationOption, noiseOption, iterationsOption, threadsOption, seedOption,
+                       corpusOption, tOffsetOption, tExpositionOption, outputOption, verboseOption});
+    parser.process(a);
+
+    verbose = parser.isSet(verboseOption);
+    qInstallMessageHandler(messageHandler);
+
+    FitBenchmark::Settings settings;
+    settings.nChannels = parser.value(channelsOption).toInt();
+    settings.duration = parser.value(durationOption).toInt();
+    settings.nIterations = parser.value(iterationsOption).toInt();
+    settings.maxThreads = parser.value(threadsOption).toInt();
+    settings.seed = parser.value(seedOption).toUInt();
+    settings.tOffset = parser.value(tOffsetOption).toInt();
+    settings.tExposition = parser.value(tExpositionOption).toInt();
+    for (QString level : parser.value(noiseOption).split(",", QString::SkipEmptyParts))
+        settings.noiseLevels << level.trimmed().toDouble();
+
+    if (settings.nChannels <= 0 || settings.duration <= 0 || settings.nIterations <= 0 || settings.maxThreads <= 0)
+    {
+        std::cerr << "Error: channels, duration, iterations and threads have to be positive" << std::endl;
+        return 1;
+    }
+
+    QJsonObject machine;
+    machine["cpu"] = QSysInfo::currentCpuArchitecture();
+    machine["os"] = QSysInfo::prettyProductName();
+    machine["ideal_thread_count"] = QThread::idealThreadCount();
+
+    QJsonObject result;
+    result["date"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    result["machine"] = machine;
+    result["channels"] = settings.nChannels;
+    result["duration"] = settings.duration;
+    result["iterations"] = settings.nIterations;
+    result["seed"] = static_cast<int>(settings.seed);
+
+    try {
+        FitBenchmark benchmark(settings);
+        result["synthetic"] = benchmark.runSynthetic();
+
+        QJsonArray scaling = benchmark.runSyntheticScaling();
+        if (parser.isSet(corpusOption))
+            for (auto corpusResult : benchmark.runCorpus(parser.value(corpusOption)))
+                scaling.append(corpusResult);
+        result["scaling"] = scaling;
+    } catch (std::exception &e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    QByteArray json = QJsonDocument(result).toJson();
+    if (parser.isSet(outputOption))
+    {
+        QFile file(parser.value(outputOption));
+        if (!file.open(QIODevice::WriteOnly))
+        {
+            std::cerr << "Error: Cannot open " << parser.value(outputOption).toStdString() << std::endl;
+            return 1;
+        }
+        file.write(json);
+    }
+    else
+    {
+        std::cout << json.toStdString();
+    }
+
+    return 0;
+}
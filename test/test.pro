@@ -1,12 +1,67 @@
 QT += testlib
-QT += gui
-CONFIG += qt warn_on depend_includepath testcase
+QT += gui widgets svg opengl printsupport concurrent
+CONFIG += qt warn_on depend_includepath testcase c++14
+QMAKE_CXXFLAGS += -D_GLIBCXX_USE_CXX11_ABI=0 -DDLIB_NO_GUI_SUPPORT
 
 TEMPLATE = app
 
+APP_DIR = $$PWD/../app
+
 SOURCES +=  tst_enoseannotator.cpp \
     tst_mvector.cpp \
-    ../app/mvector.cpp \
+    $$APP_DIR/classes/aclass.cpp \
+    $$APP_DIR/classes/annotation.cpp \
+    $$APP_DIR/classes/batchedleastsquaresfitter.cpp \
+    $$APP_DIR/classes/curvefitcache.cpp \
+    $$APP_DIR/classes/curvefitworker.cpp \
+    $$APP_DIR/classes/enosecolor.cpp \
+    $$APP_DIR/classes/fitmodelregistry.cpp \
+    $$APP_DIR/classes/functionalisation.cpp \
+    $$APP_DIR/classes/functionalisationindex.cpp \
+    $$APP_DIR/classes/leastsquaresfitter.cpp \
+    $$APP_DIR/classes/measurementdata.cpp \
+    $$APP_DIR/classes/mvector.cpp \
+    $$APP_DIR/classes/windowbuffer.cpp \
+    $$APP_DIR/lib/dlib/dlib/all/source.cpp \
+    $$APP_DIR/widgets/graphexporter.cpp \
+    $$APP_DIR/widgets/linegraphwidget.cpp \
+    $$APP_DIR/widgets/plotcanvas.cpp \
+    $$APP_DIR/widgets/renderscheduler.cpp \
+    $$APP_DIR/widgets/timeaxis.cpp \
 
 HEADERS += \
-    ../app/mvector.h \
+    $$APP_DIR/classes/aclass.h \
+    $$APP_DIR/classes/annotation.h \
+    $$APP_DIR/classes/batchedleastsquaresfitter.h \
+    $$APP_DIR/classes/curvefitcache.h \
+    $$APP_DIR/classes/curvefitworker.h \
+    $$APP_DIR/classes/defaultSettings.h \
+    $$APP_DIR/classes/enosecolor.h \
+    $$APP_DIR/classes/fitmodelregistry.h \
+    $$APP_DIR/classes/fitmodels.h \
+    $$APP_DIR/classes/functionalisation.h \
+    $$APP_DIR/classes/functionalisationindex.h \
+    $$APP_DIR/classes/leastsquaresfitter.h \
+    $$APP_DIR/classes/measurementdata.h \
+    $$APP_DIR/classes/mvector.h \
+    $$APP_DIR/classes/windowbuffer.h \
+    $$APP_DIR/widgets/fixedplotmagnifier.h \
+    $$APP_DIR/widgets/fixedplotzoomer.h \
+    $$APP_DIR/widgets/graphexporter.h \
+    $$APP_DIR/widgets/linegraphwidget.h \
+    $$APP_DIR/widgets/plotcanvas.h \
+    $$APP_DIR/widgets/renderscheduler.h \
+    $$APP_DIR/widgets/timeaxis.h \
+
+# dlib
+INCLUDEPATH += $$APP_DIR/lib/dlib
+DEPENDPATH += $$APP_DIR/lib/dlib
+
+# qwt: CurveData of linegraphwidget
+unix: QWT_ROOT = /usr/local/qwt-6.1.5
+win32: QWT_ROOT = C:/qwt-6.1.5
+
+include ( $$QWT_ROOT/features/qwt.prf )
+LIBS += -L$$QWT_ROOT/lib -lqwt
+INCLUDEPATH += $$QWT_ROOT/include
+DEPENDPATH += $$QWT_ROOT/include
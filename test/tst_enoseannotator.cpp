@@ -1,8 +1,187 @@
 #include <QtTest>
 #include <QCoreApplication>
 
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <functional>
+#include <random>
+#include <stdexcept>
+
 // add necessary includes here
-#include "../app/mvector.h"
+#include "../app/classes/mvector.h"
+#include "../app/classes/functionalisation.h"
+#include "../app/classes/functionalisationindex.h"
+#include "../app/classes/windowbuffer.h"
+#include "../app/widgets/linegraphwidget.h"
+
+/*!
+ * \brief baselineFuncAverage is the func average of MVector::getFuncAverageVector before FunctionalisationIndex was introduced
+ */
+static std::vector<double> baselineFuncAverage(const std::vector<double> &vector, const Functionalisation &functionalisation, const std::vector<bool> &sensorFailures)
+{
+    auto funcMap = functionalisation.getFuncMap(sensorFailures);
+
+    // no funcs set:
+    // return vector
+    if (funcMap.size() == 1)
+        return vector;
+
+    std::vector<double> funcVector(funcMap.size(), 0.);
+    for (int i=0; i<functionalisation.size(); i++)
+    {
+        if (!sensorFailures[i])
+        {
+            int func = functionalisation[i];
+            int vectorIndex = funcMap.keys().indexOf(func);
+            funcVector[vectorIndex] += vector[i] / funcMap[func];
+        }
+    }
+
+    return funcVector;
+}
+
+/*!
+ * \brief baselineFuncMedianAverage is the func median average of MVector::getFuncMedianAverageVector before FunctionalisationIndex was introduced
+ */
+static std::vector<double> baselineFuncMedianAverage(const std::vector<double> &vector, const Functionalisation &functionalisation, const std::vector<bool> &sensorFailures, int nMedian)
+{
+    auto funcMap = functionalisation.getFuncMap(sensorFailures);
+
+    std::vector<double> medianAverageVector(funcMap.size(), 0.);
+
+    QMap<int, QList<double>> funcValueMap;
+    for (int i=0; i<functionalisation.size(); i++)
+    {
+        if (!sensorFailures[i])
+        {
+            int func = functionalisation[i];
+            funcValueMap[func].append(vector[i]);
+        }
+    }
+
+    for (int func : funcValueMap.keys())
+    {
+        if (funcValueMap[func].size() > nMedian)
+        {
+            std::sort(funcValueMap[func].begin(), funcValueMap[func].end());
+
+            // remove non-median values alternately from the front and the back
+            bool removeLast = false;
+            while(funcValueMap[func].size() > nMedian)
+            {
+                if (removeLast)
+                    funcValueMap[func].removeLast();
+                else
+                    funcValueMap[func].removeFirst();
+
+                removeLast = !removeLast;
+            }
+        }
+
+        int vectorIndex = funcMap.keys().indexOf(func);
+        for (int i=0; i<funcValueMap[func].size(); i++)
+            medianAverageVector[vectorIndex] += funcValueMap[func][i] / funcValueMap[func].size();
+    }
+
+    return medianAverageVector;
+}
+
+/*!
+ * \brief funcGroups returns the values of the working channels of each func, in ascending order of the funcs.
+ * Funcs whose channels all failed have an empty group.
+ */
+static std::vector<std::vector<double>> funcGroups(const std::vector<double> &vector, const Functionalisation &functionalisation, const std::vector<bool> &sensorFailures)
+{
+    auto funcMap = functionalisation.getFuncMap(sensorFailures);
+
+    std::vector<std::vector<double>> groups(funcMap.size());
+    for (int i=0; i<functionalisation.size(); i++)
+        if (!sensorFailures[i])
+            groups[funcMap.keys().indexOf(functionalisation[i])].push_back(vector[i]);
+
+    return groups;
+}
+
+static double referenceMedian(std::vector<double> values)
+{
+    std::sort(values.begin(), values.end());
+    size_t size = values.size();
+
+    return size % 2 == 1 ? values[size/2] : (values[size/2 - 1] + values[size/2]) / 2.;
+}
+
+static double referenceMAD(const std::vector<double> &values, double center)
+{
+    std::vector<double> deviations;
+    for (double value : values)
+        deviations.push_back(std::abs(value - center));
+
+    return referenceMedian(deviations);
+}
+
+static double referenceTrimmedMean(std::vector<double> values, double fraction)
+{
+    std::sort(values.begin(), values.end());
+    size_t nTrim = static_cast<size_t>(fraction * values.size());
+
+    double sum = 0.;
+    for (size_t i=nTrim; i<values.size()-nTrim; i++)
+        sum += values[i];
+
+    return sum / (values.size() - 2 * nTrim);
+}
+
+/*!
+ * \brief referenceHuber solves sum(psi(x - location)) = 0 by bisection, psi clips the residuals to the Huber threshold.
+ * The sum decreases monotonically with the location, the solution lies between the min and max value.
+ */
+static double referenceHuber(const std::vector<double> &values, double k)
+{
+    double median = referenceMedian(values);
+    double threshold = k * 1.4826 * referenceMAD(values, median);
+    if (threshold <= 0.)
+        return median;
+
+    auto psiSum = [&](double location) {
+        double sum = 0.;
+        for (double value : values)
+            sum += std::max(-threshold, std::min(threshold, value - location));
+        return sum;
+    };
+
+    double low = *std::min_element(values.begin(), values.end());
+    double high = *std::max_element(values.begin(), values.end());
+    for (int i=0; i<200; i++)
+    {
+        double mid = (low + high) / 2.;
+        if (psiSum(mid) > 0.)
+            low = mid;
+        else
+            high = mid;
+    }
+
+    return (low + high) / 2.;
+}
+
+static double referenceClippedMean(const std::vector<double> &values, double threshold)
+{
+    double median = referenceMedian(values);
+    double maxDeviation = threshold * 1.4826 * referenceMAD(values, median);
+
+    double sum = 0.;
+    int count = 0;
+    for (double value : values)
+    {
+        if (std::abs(value - median) <= maxDeviation)
+        {
+            sum += value;
+            count++;
+        }
+    }
+
+    return count > 0 ? sum / count : median;
+}
 
 class TestENoseAnnotator : public QObject
 {
@@ -16,10 +195,22 @@ private slots:
     void initTestCase();
     void cleanupTestCase();
     void test_mvector();
+    void test_functionalisationIndex_data();
+    void test_functionalisationIndex();
+    void test_functionalisationIndex_robust_data();
+    void test_functionalisationIndex_robust();
+    void test_windowBuffer();
+    void test_curveData_levelOfDetail();
+    void test_curveData_range();
+
+private:
+    std::mt19937 generator;
 
+    std::vector<double> randomValues(int size, double min, double max);
 };
 
-TestENoseAnnotator::TestENoseAnnotator()
+TestENoseAnnotator::TestENoseAnnotator():
+    generator(42)
 {
 
 }
@@ -39,27 +230,408 @@ void TestENoseAnnotator::cleanupTestCase()
 
 }
 
+std::vector<double> TestENoseAnnotator::randomValues(int size, double min, double max)
+{
+    std::uniform_real_distribution<double> distribution(min, max);
+
+    std::vector<double> values(static_cast<size_t>(size));
+    for (double &value : values)
+        value = distribution(generator);
+
+    return values;
+}
+
 void TestENoseAnnotator::test_mvector()
 {
     MVector vector;
 
     // test init
     bool test = true;
-    for (int i=0; i<MVector::size; i++)
-        if (vector.array[i] != 0.0)
+    for (size_t i=0; i<vector.getSize(); i++)
+        if (vector[static_cast<int>(i)] != 0.0)
             test = false;
     QVERIFY(test);
 
     // test == and !=
     MVector vectorZero, vectorNotZero;
 
-    vectorNotZero.array[MVector::size/2] = 0.1;
+    vectorNotZero[static_cast<int>(MVector::nChannels/2)] = 0.1;
 
     QVERIFY (vectorZero != vectorNotZero);
     QVERIFY (! (vectorZero == vectorNotZero));
     QVERIFY (vector == vectorZero);
 }
 
+void TestENoseAnnotator::test_functionalisationIndex_data()
+{
+    QTest::addColumn<int>("nFuncs");
+    QTest::addColumn<double>("failureRate");
+    QTest::addColumn<bool>("failedFunc");
+
+    QTest::newRow("no funcs") << 1 << 0. << false;
+    QTest::newRow("no funcs, failures") << 1 << 0.2 << false;
+    QTest::newRow("2 funcs") << 2 << 0. << false;
+    QTest::newRow("5 funcs, failures") << 5 << 0.2 << false;
+    QTest::newRow("5 funcs, failed func") << 5 << 0.2 << true;
+    QTest::newRow("12 funcs, failures") << 12 << 0.3 << false;
+    QTest::newRow("12 funcs, failed func") << 12 << 0.3 << true;
+}
+
+/*!
+ * \brief TestENoseAnnotator::test_functionalisationIndex compares the func vectors of FunctionalisationIndex with the baseline algorithms
+ * for random functionalisations, sensor failures and channel values. The results have to be identical.
+ */
+void TestENoseAnnotator::test_functionalisationIndex()
+{
+    QFETCH(int, nFuncs);
+    QFETCH(double, failureRate);
+    QFETCH(bool, failedFunc);
+
+    const int nChannels = static_cast<int>(MVector::nChannels);
+    std::uniform_int_distribution<int> funcDistribution(0, nFuncs - 1);
+    std::bernoulli_distribution failureDistribution(failureRate);
+
+    for (int run=0; run<20; run++)
+    {
+        Functionalisation functionalisation(static_cast<size_t>(nChannels), 0);
+        std::vector<bool> sensorFailures(static_cast<size_t>(nChannels), false);
+        for (int i=0; i<nChannels; i++)
+        {
+            functionalisation[i] = funcDistribution(generator);
+            sensorFailures[i] = failureDistribution(generator);
+        }
+
+        // func whose channels all failed:
+        // kept as an empty group
+        if (failedFunc)
+        {
+            for (int i=nChannels-4; i<nChannels; i++)
+            {
+                functionalisation[i] = nFuncs;
+                sensorFailures[i] = true;
+            }
+        }
+
+        std::vector<double> values = randomValues(nChannels, -50., 150.);
+        MVector vector;
+        for (int i=0; i<nChannels; i++)
+            vector[i] = values[i];
+
+        // func vectors of MVector
+        std::vector<double> average = vector.getFuncVector(functionalisation, sensorFailures, InputFunctionType::average).getVector();
+        QCOMPARE(average, baselineFuncAverage(values, functionalisation, sensorFailures));
+
+        std::vector<double> medianAverage = vector.getFuncVector(functionalisation, sensorFailures, InputFunctionType::medianAverage).getVector();
+        QCOMPARE(medianAverage, baselineFuncMedianAverage(values, functionalisation, sensorFailures, 4));
+
+        // median average with even and odd numbers of surplus values
+        FunctionalisationIndex index(functionalisation, sensorFailures);
+        QCOMPARE(index.getNFuncs(), functionalisation.getFuncMap(sensorFailures).size());
+        for (int nMedian=1; nMedian<=6; nMedian++)
+        {
+            std::vector<double> output(static_cast<size_t>(index.getNFuncs()), -1.);
+            index.medianAverage(values.data(), output.data(), nMedian);
+            QCOMPARE(output, baselineFuncMedianAverage(values, functionalisation, sensorFailures, nMedian));
+        }
+    }
+}
+
+void TestENoseAnnotator::test_functionalisationIndex_robust_data()
+{
+    QTest::addColumn<QVector<int>>("funcs");
+    QTest::addColumn<QVector<double>>("values");
+    QTest::addColumn<QVector<bool>>("failures");
+
+    // clean values with single outliers per func
+    QTest::newRow("outliers")
+            << QVector<int>{0, 0, 0, 0, 0, 0, 0, 0,   1, 1, 1, 1, 1, 1, 1, 1,   2, 2, 2, 2, 2, 2, 2, 2}
+            << QVector<double>{1.0, 1.2, 0.9, 1.1, 1.05, 0.95, 50., 1.15,
+                               -3., -2.8, -3.1, -2.9, -3.3, -120., -3.05, -2.95,
+                               10., 11., 9., 10.5, 9.5, 10.2, 9.8, 200.}
+            << QVector<bool>{false, false, false, false, false, false, false, false,
+                             false, false, false, false, false, false, false, false,
+                             false, false, true, false, false, false, false, false};
+
+    // more than half of the values equal the median:
+    // the huber estimate is the median, the clipped mean keeps the values at the median
+    QTest::newRow("MAD 0")
+            << QVector<int>{0, 0, 0, 0, 0,   1, 1, 1, 1,   2, 2, 2, 2, 2}
+            << QVector<double>{2., 2., 2., 2., 100.,   1., 1., 1., 5.,   4., 4., 4., 9., -3.}
+            << QVector<bool>(14, false);
+
+    QTest::newRow("single channel")
+            << QVector<int>{0,   1,   2, 2, 2}
+            << QVector<double>{3.5,   -7.,   0.25, 8., 9.}
+            << QVector<bool>{false,   false,   false, true, true};
+
+    // func 1 is kept as an empty group
+    QTest::newRow("failed func")
+            << QVector<int>{0, 0, 0, 0,   1, 1,   2, 2, 2}
+            << QVector<double>{1., 2., 3., 100.,   5., 6.,   7., 8., 90.}
+            << QVector<bool>{false, false, false, false,   true, true,   false, false, false};
+
+    QTest::newRow("no funcs")
+            << QVector<int>(12, 0)
+            << QVector<double>{4., 4.2, 3.9, 4.1, -60., 4.05, 3.95, 4.15, 4.3, 3.7, 75., 4.}
+            << QVector<bool>{false, false, false, true, false, false, false, false, false, false, false, false};
+}
+
+/*!
+ * \brief TestENoseAnnotator::test_functionalisationIndex_robust compares the robust estimators of FunctionalisationIndex
+ * with straightforward implementations and checks that aggregate selects them
+ */
+void TestENoseAnnotator::test_functionalisationIndex_robust()
+{
+    QFETCH(QVector<int>, funcs);
+    QFETCH(QVector<double>, values);
+    QFETCH(QVector<bool>, failures);
+
+    Functionalisation functionalisation(static_cast<size_t>(funcs.size()), 0);
+    for (int i=0; i<funcs.size(); i++)
+        functionalisation[i] = funcs[i];
+    std::vector<bool> sensorFailures(failures.begin(), failures.end());
+    std::vector<double> input = values.toStdVector();
+
+    FunctionalisationIndex index(functionalisation, sensorFailures);
+    auto groups = funcGroups(input, functionalisation, sensorFailures);
+    QCOMPARE(index.getNFuncs(), static_cast<int>(groups.size()));
+
+    QList<QPair<InputFunctionType, std::function<double(const std::vector<double>&)>>> estimators {
+        {InputFunctionType::trimmedMean, [](const std::vector<double> &group) { return referenceTrimmedMean(group, FUNC_TRIMMED_MEAN_FRACTION); }},
+        {InputFunctionType::huber, [](const std::vector<double> &group) { return referenceHuber(group, FUNC_HUBER_K); }},
+        {InputFunctionType::clippedMean, [](const std::vector<double> &group) { return referenceClippedMean(group, FUNC_CLIPPED_MEAN_THRESHOLD); }}
+    };
+
+    for (const auto &estimator : estimators)
+    {
+        std::vector<double> output(groups.size(), -1.);
+        index.aggregate(input.data(), output.data(), estimator.first);
+
+        // the huber estimate converges to a tolerance relative to its threshold
+        double tolerance = estimator.first == InputFunctionType::huber ? 1e-4 : 1e-9;
+
+        for (size_t group=0; group<groups.size(); group++)
+        {
+            // funcs without working channels are set to 0
+            double expected = groups[group].empty() ? 0. : estimator.second(groups[group]);
+            QVERIFY2(std::abs(output[group] - expected) <= tolerance * (1. + std::abs(expected)),
+                     qPrintable(QString("func %1: %2 instead of %3").arg(group).arg(output[group]).arg(expected)));
+        }
+    }
+
+    // aggregate selects the estimators
+    std::vector<double> expected(groups.size()), output(groups.size());
+
+    index.trimmedMean(input.data(), expected.data());
+    index.aggregate(input.data(), output.data(), InputFunctionType::trimmedMean);
+    QCOMPARE(output, expected);
+
+    index.huber(input.data(), expected.data());
+    index.aggregate(input.data(), output.data(), InputFunctionType::huber);
+    QCOMPARE(output, expected);
+
+    index.clippedMean(input.data(), expected.data());
+    index.aggregate(input.data(), output.data(), InputFunctionType::clippedMean);
+    QCOMPARE(output, expected);
+
+    index.medianAverage(input.data(), expected.data(), 3);
+    index.aggregate(input.data(), output.data(), InputFunctionType::medianAverage, 3);
+    QCOMPARE(output, expected);
+
+    index.average(input.data(), expected.data());
+    index.aggregate(input.data(), output.data(), InputFunctionType::average);
+    QCOMPARE(output, expected);
+
+    // none keeps the channel values
+    QVERIFY_EXCEPTION_THROWN(index.aggregate(input.data(), output.data(), InputFunctionType::none), std::invalid_argument);
+}
+
+/*!
+ * \brief TestENoseAnnotator::test_windowBuffer compares WindowBuffer with a deque of the last W vectors
+ */
+void TestENoseAnnotator::test_windowBuffer()
+{
+    const int W = 3;
+    const int N = 4;
+
+    WindowBuffer buffer(W, N);
+    std::deque<std::vector<double>> reference;
+
+    QCOMPARE(buffer.size(), 0);
+    QVERIFY(!buffer.isFull());
+    QVERIFY(buffer.window().empty());
+
+    for (int i=0; i<10; i++)
+    {
+        std::vector<double> vector = randomValues(N, 0., 1.);
+        buffer.push(vector);
+
+        reference.push_back(vector);
+        if (static_cast<int>(reference.size()) > W)
+            reference.pop_front();
+
+        std::vector<double> expected;
+        for (const auto &referenceVector : reference)
+            expected.insert(expected.end(), referenceVector.begin(), referenceVector.end());
+
+        QCOMPARE(buffer.size(), static_cast<int>(reference.size()));
+        QCOMPARE(buffer.isFull(), static_cast<int>(reference.size()) == W);
+        QCOMPARE(buffer.window(), expected);
+    }
+
+    // cleared buffer is refilled from the start
+    buffer.clear();
+    QCOMPARE(buffer.size(), 0);
+    QVERIFY(!buffer.isFull());
+    QVERIFY(buffer.window().empty());
+
+    std::vector<double> vector = randomValues(N, 0., 1.);
+    buffer.push(vector);
+    QCOMPARE(buffer.window(), vector);
+
+    // invalid arguments
+    QVERIFY_EXCEPTION_THROWN(buffer.push(std::vector<double>(N + 1, 0.)), std::invalid_argument);
+    QVERIFY_EXCEPTION_THROWN(WindowBuffer(0, N), std::invalid_argument);
+    QVERIFY_EXCEPTION_THROWN(WindowBuffer(-1, N), std::invalid_argument);
+    QVERIFY_EXCEPTION_THROWN(WindowBuffer(W, -1), std::invalid_argument);
+}
+
+/*!
+ * \brief TestENoseAnnotator::test_curveData_levelOfDetail checks the samples served by the level of detail of CurveData
+ * against all samples of the curve: decimated samples are samples of the curve in ascending order of x,
+ * at most two per block, and keep the extreme values of the visible range.
+ */
+void TestENoseAnnotator::test_curveData_levelOfDetail()
+{
+    const int nSamples = 20000;
+
+    QVector<double> times;
+    for (int i=0; i<nSamples; i++)
+        times << 1000. * i;
+
+    std::vector<double> values = randomValues(nSamples, -100., 100.);
+    QVector<double> curveValues = QVector<double>::fromStdVector(values);
+
+    CurveData curve(&times);
+    curve.setValues(curveValues);
+    QCOMPARE(curve.getLast(), nSamples);
+
+    // bounding rect of all samples
+    auto minMax = std::minmax_element(values.begin(), values.end());
+    QRectF boundingRect = curve.boundingRect();
+    QCOMPARE(boundingRect.left(), times.first());
+    QCOMPARE(boundingRect.right(), times.last());
+    QCOMPARE(boundingRect.top(), *minMax.first);
+    QCOMPARE(boundingRect.bottom(), *minMax.second);
+
+    for (int maxBlocks : {10, 100, 1000, 20000})
+    {
+        for (QPair<int, int> range : QList<QPair<int, int>>{{0, nSamples}, {1234, 5678}, {10000, 10050}})
+        {
+            QRectF rect(times[range.first], -1000., times[range.second - 1] - times[range.first], 2000.);
+            QVector<QPointF> samples = curve.getDecimatedSamples(rect, maxBlocks);
+
+            // one sample left and right of rect
+            int first = std::max(0, range.first - 1);
+            int last = std::min(nSamples, range.second + 1);
+            int count = last - first;
+
+            QVERIFY(!samples.isEmpty());
+            QVERIFY(samples.size() <= std::max(count, 2 * maxBlocks + 2));
+
+            // samples of the curve in ascending order:
+            // block extremes may lie outside the range, as blocks are aligned to multiples of the block size
+            bool decimated = count > 2 * maxBlocks;
+            for (int i=0; i<samples.size(); i++)
+            {
+                int index = static_cast<int>(samples[i].x() / 1000.);
+                QVERIFY(index >= 0 && index < nSamples);
+                if (!decimated)
+                    QVERIFY(index >= first && index < last);
+                QCOMPARE(samples[i].y(), values[static_cast<size_t>(index)]);
+                if (i > 0)
+                    QVERIFY(samples[i].x() > samples[i-1].x());
+            }
+
+            // few samples: all samples are served
+            if (!decimated)
+            {
+                QCOMPARE(samples.size(), count);
+                continue;
+            }
+
+            // extreme values of the visible samples are kept
+            auto rangeMinMax = std::minmax_element(values.begin() + range.first, values.begin() + range.second);
+            double minY = qInf(), maxY = -qInf();
+            for (const QPointF &sample : samples)
+            {
+                minY = std::min(minY, sample.y());
+                maxY = std::max(maxY, sample.y());
+            }
+            QVERIFY(minY <= *rangeMinMax.first);
+            QVERIFY(maxY >= *rangeMinMax.second);
+        }
+    }
+}
+
+/*!
+ * \brief TestENoseAnnotator::test_curveData_range checks curves serving a range of another curve (selection curves)
+ */
+void TestENoseAnnotator::test_curveData_range()
+{
+    const int nSamples = 5000;
+
+    QVector<double> times;
+    for (int i=0; i<nSamples; i++)
+        times << 1000. * i;
+
+    std::vector<double> values = randomValues(nSamples, 0., 10.);
+    QVector<double> curveValues = QVector<double>::fromStdVector(values);
+
+    CurveData curve(&times);
+    curve.setValues(curveValues);
+
+    CurveData selection(&curve);
+    QCOMPARE(selection.getFirst(), 0);
+    QCOMPARE(selection.getLast(), 0);
+    QVERIFY(selection.getDecimatedSamples(QRectF(), 100).isEmpty());
+
+    selection.setRange(100, 300);
+    QCOMPARE(selection.getFirst(), 100);
+    QCOMPARE(selection.getLast(), 300);
+
+    // few samples: the range is served unchanged
+    QVector<QPointF> samples = selection.getDecimatedSamples(QRectF(), 1000);
+    QCOMPARE(samples.size(), 200);
+    for (int i=0; i<samples.size(); i++)
+        QCOMPARE(samples[i], QPointF(times[100 + i], values[static_cast<size_t>(100 + i)]));
+
+    auto minMax = std::minmax_element(values.begin() + 100, values.begin() + 300);
+    QRectF boundingRect = selection.boundingRect();
+    QCOMPARE(boundingRect.left(), times[100]);
+    QCOMPARE(boundingRect.right(), times[299]);
+    QCOMPARE(boundingRect.top(), *minMax.first);
+    QCOMPARE(boundingRect.bottom(), *minMax.second);
+
+    // decimated: only samples of the range
+    samples = selection.getDecimatedSamples(QRectF(), 10);
+    QVERIFY(!samples.isEmpty());
+    for (const QPointF &sample : samples)
+        QVERIFY(sample.x() >= times[100] && sample.x() <= times[299]);
+
+    // index range by binary search within the range
+    QPair<int, int> indexRange = selection.getIndexRange(times[50], times[150]);
+    QCOMPARE(indexRange.first, 100);
+    QCOMPARE(indexRange.second, 151);
+
+    // ranges are limited to the samples of the source
+    selection.setRange(4900, 6000);
+    QCOMPARE(selection.getLast(), nSamples);
+
+    selection.clear();
+    QCOMPARE(selection.getLast(), 0);
+}
+
 QTEST_MAIN(TestENoseAnnotator)
 
 #include "tst_enoseannotator.moc"